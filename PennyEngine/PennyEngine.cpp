@@ -19,6 +19,30 @@ void PennyEngine::setFramerateLimit(int framerate) {
     _instance.framerateLimit = framerate;
 }
 
+void PennyEngine::setUpdateRate(int updatesPerSecond) {
+    _instance.updateRate = updatesPerSecond;
+}
+
+int PennyEngine::getUpdateRate() {
+    return _instance.updateRate;
+}
+
+sf::Time PennyEngine::getElapsedTime() {
+    return _instance.getElapsedTime();
+}
+
+float PennyEngine::getFrameInterpolation() {
+    return _instance.getFrameInterpolation();
+}
+
+pe::FrameArena& PennyEngine::getFrameArena() {
+    return _instance.getFrameArena();
+}
+
+pe::TaskScheduler& PennyEngine::getTaskScheduler() {
+    return _instance.getTaskScheduler();
+}
+
 sf::RenderWindow& PennyEngine::getWindow() {
     return _instance.window;
 }
@@ -83,8 +107,8 @@ void PennyEngine::setMouseCursor(std::string path) {
     _instance.cursorImagePath = path;
 }
 
-void PennyEngine::addInputListener(pe::intern::InputListener* listener) {
-    _instance.getInputManager().addListener(listener);
+void PennyEngine::addInputListener(pe::intern::InputListener* listener, int priority) {
+    _instance.getInputManager().addListener(listener, priority);
 }
 
 void PennyEngine::setAppName(std::string name) {
@@ -111,6 +135,18 @@ bool PennyEngine::playerIsUsingMouse() {
     return _usingMouse;
 }
 
+void PennyEngine::addStartupTask(std::function<void()> task) {
+    _instance.addStartupTask(std::move(task));
+}
+
+const std::vector<pe::StartupTiming>& PennyEngine::getStartupTimings() {
+    return _instance.getStartupTimings();
+}
+
+double PennyEngine::getTimeToFirstFrame() {
+    return _instance.getTimeToFirstFrame();
+}
+
 sf::Vector2f PennyEngine::getUIMouseOffset() {
     return _instance.getInputManager().getUIMouseOffset();
 }
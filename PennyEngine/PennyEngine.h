@@ -21,6 +21,22 @@ public:
 
     static void setFramerateLimit(int framerate);
 
+    // How many times per second GameManager::update() and the UI are updated,
+    // independent of how often frames are rendered
+    static void setUpdateRate(int updatesPerSecond);
+    static int getUpdateRate();
+
+    // Time since the engine was started; use this for animations instead of counting frames
+    static sf::Time getElapsedTime();
+    // How far (0-1) the current frame is between the last update and the next one
+    static float getFrameInterpolation();
+
+    // Scratch memory that is released at the end of every frame
+    static pe::FrameArena& getFrameArena();
+
+    // Worker threads for background work; use this instead of starting threads
+    static pe::TaskScheduler& getTaskScheduler();
+
     static sf::RenderWindow& getWindow();
     static sf::View& getCamera();
 
@@ -45,7 +61,7 @@ public:
     static void setAppIcon(std::string path);
     static void setMouseCursor(std::string path);
 
-    static void addInputListener(pe::intern::InputListener* listener);
+    static void addInputListener(pe::intern::InputListener* listener, int priority = 0);
 
     static void setAppName(std::string name);
     static std::string getAppName();
@@ -56,6 +72,14 @@ public:
 
     static bool playerIsUsingMouse();
 
+    // Work that can be done while the window opens, like reading settings or a file to open.
+    // Tasks run on their own threads and are all finished before GameManager::init()
+    static void addStartupTask(std::function<void()> task);
+    // When each step of startup finished, up to the first frame being shown
+    static const std::vector<pe::StartupTiming>& getStartupTimings();
+    // In milliseconds, or 0 if the first frame hasn't been shown yet
+    static double getTimeToFirstFrame();
+
     static sf::Vector2f getUIMouseOffset();
 
     friend class pe::intern::InputEventDistributor;
@@ -5,35 +5,60 @@
 #define _SOUND_MANAGER_H
 
 #include <map>
+#include <memory>
+#include <filesystem>
 #include "../core/Logger.h"
+#include "../core/Defines.h"
 #include "soloud.h"
 #include "soloud_wav.h"
+#include "soloud_wavstream.h"
 
 namespace pe {
+    /*
+        Sounds are found when the engine starts but aren't decoded until
+        they're first played, so startup time and memory don't grow with
+        the number of files in res/sounds. Music in res/sounds/music is
+        streamed from disk rather than decoded up front.
+
+        Either folder can be missing, in which case there's nothing to play.
+    */
     class SoundManager {
     public:
         static void playSound(std::string soundName) {
-            if (sounds.find(soundName) == sounds.end()) {
+            if (_failedInit) return;
+
+            const auto& sound = getSound(soundName);
+            if (sound == nullptr) return;
+            soloud.play(*sound);
+        }
+
+        static void setVolume(std::string soundName, float volume) {
+            const auto it = sounds.find(soundName);
+            if (it == sounds.end()) {
                 Logger::log("No sound named \"" + soundName + "\"");
                 return;
             }
-            soloud.play(sounds[soundName]);
-        }
 
-        static void setVolume(std::string soundName, float volume) {
-            sounds[soundName].setVolume(volume);
+            it->second.volume = volume;
+            if (it->second.wav != nullptr) it->second.wav->setVolume(volume);
         }
 
         static void playSong(std::string musicName, bool loop = true) {
+            if (_failedInit) return;
+
+            const auto& song = getSong(musicName);
+            if (song == nullptr) return;
+
             stopMusic();
-            music[musicName].setLooping(loop);
-            _currentSong = soloud.play(music[musicName]);
-            _songLength = music[musicName].getLength();
+            song->setLooping(loop);
+            _currentSong = soloud.play(*song);
+            _songLength = song->getLength();
             _songIsPlaying = true;
             _songStartTimeMillis = currentTimeMillis();
         }
 
         static bool musicIsPlaying() {
+            if (!_songIsPlaying) return false;
             if (soloud.getLooping(_currentSong)) {
                 return _songIsPlaying;
             } else {
@@ -42,23 +67,32 @@ namespace pe {
         }
 
         static void stopSong(std::string songName) {
-            music[songName].stop();
+            const auto it = music.find(songName);
+            if (it != music.end() && it->second.stream != nullptr) it->second.stream->stop();
             _songIsPlaying = false;
         }
 
         static void stopMusic() {
-            for (const auto& songName : musicNames) {
-                stopSong(songName);
+            for (const auto& song : music) {
+                stopSong(song.first);
             }
         }
 
         static void setSongVolume(std::string songName, float volume) {
-            music[songName].setVolume(volume);
+            const auto it = music.find(songName);
+            if (it == music.end()) {
+                Logger::log("No song named \"" + songName + "\"");
+                return;
+            }
+
+            it->second.volume = volume;
+            if (it->second.stream != nullptr) it->second.stream->setVolume(volume);
         }
 
         static void setMusicVolume(float volume) {
             for (auto& song : music) {
-                song.second.setVolume(volume);
+                song.second.volume = volume;
+                if (song.second.stream != nullptr) song.second.stream->setVolume(volume);
             }
 
             if (_songIsPlaying) {
@@ -68,10 +102,12 @@ namespace pe {
 
         static void setSfxVolume(float volume) {
             for (auto& sound : sounds) {
-                sound.second.setVolume(volume);
+                sound.second.volume = volume;
+                if (sound.second.wav != nullptr) sound.second.wav->setVolume(volume);
             }
         }
 
+        // Only looks for sound files; nothing is read from them until it's played
         static void loadSounds() {
             const SoLoud::result result = soloud.init();
             if (result != 0) {
@@ -82,69 +118,113 @@ namespace pe {
                 return;
             }
 
-            const std::string dirName = "res/sounds";
-            std::vector<std::string> soundFiles;
-            for (const auto& entry : std::filesystem::directory_iterator(dirName)) {
-                if (splitString(splitString(entry.path().string(), "\\")[1], ".").size() != 2) continue;
-                else if (splitString(splitString(entry.path().string(), "\\")[1], ".")[1] != "wav") continue;
-                soundFiles.push_back(splitString(entry.path().string(), "\\")[1]);
-            }
-
-            for (const auto& soundFile : soundFiles) {
-                std::string soundName = splitString(soundFile, ".")[0];
-                soundNames.push_back(soundName);
-            }
-
-            for (int i = 0; i < soundNames.size(); i++) {
-                std::string filePath = "res/sounds/" + soundNames[i] + ".wav";
-                if (sounds[soundNames[i]].load(filePath.c_str()) != 0) {
-                    Logger::log("Could not load " + soundNames[i] + ".wav");
-                } else sounds[soundNames[i]].setSingleInstance(true);
-            }
-
-            const std::string musicDirName = "res/sounds/music";
-            std::vector<std::string> musicFiles;
-            for (const auto& entry : std::filesystem::directory_iterator(musicDirName)) {
-                if (splitString(splitString(entry.path().string(), "\\")[1], ".").size() != 2) continue;
-                else if (splitString(splitString(entry.path().string(), "\\")[1], ".")[1] != "wav") continue;
-                musicFiles.push_back(splitString(entry.path().string(), "\\")[1]);
-            }
-
-            for (const auto& musicFile : musicFiles) {
-                std::string songName = splitString(musicFile, ".")[0];
-                musicNames.push_back(songName);
+            for (const auto& [name, path] : findWavFiles("res/sounds")) {
+                sounds[name].path = path;
             }
 
-            for (int i = 0; i < musicNames.size(); i++) {
-                std::string filePath = "res/sounds/music/" + musicNames[i] + ".wav";
-                if (music[musicNames[i]].load(filePath.c_str()) != 0) {
-                    Logger::log("Could not load " + musicNames[i] + ".wav");
-                } else {
-                    music[musicNames[i]].setSingleInstance(true);
-                    music[musicNames[i]].setLooping(true);
-                }
+            for (const auto& [name, path] : findWavFiles("res/sounds/music")) {
+                music[name].path = path;
             }
         }
 
         static void shutdown() {
+            if (_failedInit) return;
+
+            // Sources have to stop before the engine does
+            stopMusic();
             soloud.deinit();
         }
 
         friend class MusicManager;
     private:
+        struct LazySound {
+            std::string path;
+            // Decoded the first time it's played
+            s_p<SoLoud::Wav> wav = nullptr;
+            float volume = 1.f;
+            bool failedToLoad = false;
+        };
+
+        struct StreamedSong {
+            std::string path;
+            // Opened the first time it's played, then read from disk as it plays
+            s_p<SoLoud::WavStream> stream = nullptr;
+            float volume = 1.f;
+            bool failedToLoad = false;
+        };
+
         inline static SoLoud::Soloud soloud;
         inline static bool _failedInit = false;
 
-        inline static std::map<std::string, SoLoud::Wav> sounds;
-        inline static std::vector<std::string> soundNames;
-
-        inline static std::map<std::string, SoLoud::Wav> music;
-        inline static std::vector<std::string> musicNames;
+        inline static std::map<std::string, LazySound> sounds;
+        inline static std::map<std::string, StreamedSong> music;
 
         inline static SoLoud::handle _currentSong;
         inline static bool _songIsPlaying = false;
         inline static SoLoud::time _songLength = 0;
         inline static long long _songStartTimeMillis = 0;
+
+        // Name (file name without .wav) and path of every .wav file directly inside dirName
+        static std::map<std::string, std::string> findWavFiles(const std::string& dirName) {
+            std::map<std::string, std::string> files;
+
+            std::error_code error;
+            if (!std::filesystem::is_directory(dirName, error)) return files;
+
+            for (const auto& entry : std::filesystem::directory_iterator(dirName, error)) {
+                if (!entry.is_regular_file(error) || entry.path().extension() != ".wav") continue;
+                files[entry.path().stem().string()] = dirName + "/" + entry.path().filename().string();
+            }
+            return files;
+        }
+
+        static const s_p<SoLoud::Wav>& getSound(const std::string& soundName) {
+            static const s_p<SoLoud::Wav> none = nullptr;
+
+            const auto it = sounds.find(soundName);
+            if (it == sounds.end()) {
+                Logger::log("No sound named \"" + soundName + "\"");
+                return none;
+            }
+
+            LazySound& sound = it->second;
+            if (sound.wav == nullptr && !sound.failedToLoad) {
+                auto wav = std::make_shared<SoLoud::Wav>();
+                if (wav->load(sound.path.c_str()) != 0) {
+                    Logger::log("Could not load " + soundName + ".wav");
+                    sound.failedToLoad = true;
+                } else {
+                    wav->setSingleInstance(true);
+                    wav->setVolume(sound.volume);
+                    sound.wav = wav;
+                }
+            }
+            return sound.wav;
+        }
+
+        static const s_p<SoLoud::WavStream>& getSong(const std::string& songName) {
+            static const s_p<SoLoud::WavStream> none = nullptr;
+
+            const auto it = music.find(songName);
+            if (it == music.end()) {
+                Logger::log("No song named \"" + songName + "\"");
+                return none;
+            }
+
+            StreamedSong& song = it->second;
+            if (song.stream == nullptr && !song.failedToLoad) {
+                auto stream = std::make_shared<SoLoud::WavStream>();
+                if (stream->load(song.path.c_str()) != 0) {
+                    Logger::log("Could not load " + songName + ".wav");
+                    song.failedToLoad = true;
+                } else {
+                    stream->setSingleInstance(true);
+                    stream->setVolume(song.volume);
+                    song.stream = stream;
+                }
+            }
+            return song.stream;
+        }
     };
 }
 
@@ -8,12 +8,40 @@
 #include "../audio/SoundManager.h"
 #include "../ui/UI.h"
 
+constexpr int MAX_UPDATES_PER_FRAME = 5;
+
+// Decodes an image off the main thread. Returns nullptr if there's no image or it couldn't be read
+static s_p<sf::Image> decodeImage(const std::string& path) {
+    if (path == "NONE") return nullptr;
+
+    const auto image = new_s_p(sf::Image, ());
+    return image->loadFromFile(path) ? image : nullptr;
+}
+
 void pe::intern::EngineInstance::start(GameManager* gameManager) {
+    _startupClock.restart();
     Logger::start();
-    SoundManager::loadSounds();
 
     this->gameManager = gameManager;
 
+    _taskScheduler.start();
+
+    // File reads and decoding run on the task scheduler while the window is created.
+    // Only the texture uploads, which need the window's context, are left for this thread
+    std::vector<std::future<void>> startupTasks;
+    startupTasks.push_back(_taskScheduler.submit(SoundManager::loadSounds));
+    for (auto& task : _startupTasks) {
+        startupTasks.push_back(_taskScheduler.submit(std::move(task)));
+    }
+    _startupTasks.clear();
+
+    auto icon = _taskScheduler.submit([this]() { return decodeImage(appIconPath); });
+    auto cursorImage = _taskScheduler.submit([this]() { return decodeImage(cursorImagePath); });
+    auto spriteSheet = _taskScheduler.submit([]() { return decodeImage(UI_SPRITE_SHEET_PATH); });
+    auto fontLoaded = _taskScheduler.submit([this]() {
+        return fontPath == "NONE" || _font.loadFromFile(fontPath);
+    });
+
     sf::RenderTexture mainSurface;
     sf::Sprite mainSurfaceSprite;
     sf::RenderTexture uiSurface;
@@ -21,32 +49,45 @@ void pe::intern::EngineInstance::start(GameManager* gameManager) {
     GfxResources resources(mainSurface, mainSurfaceSprite, uiSurface, uiSurfaceSprite);
 
     createWindow(resources);
+    // Cleared straight away so the window isn't left blank while everything else loads
+    window.clear();
+    window.display();
+    markStartupPhase("windowShown");
 
     UI::_instance.setSurface(&uiSurface);
 
     connectGamepad();
 
-    sf::Image icon;
-    if (appIconPath != "NONE" && icon.loadFromFile(appIconPath)) {
-        window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
+    const auto iconImage = icon.get();
+    if (iconImage != nullptr) {
+        window.setIcon(iconImage->getSize().x, iconImage->getSize().y, iconImage->getPixelsPtr());
     }
 
     sf::Cursor cursor;
-    sf::Image cursorImage;
-    if (cursorImagePath != "NONE" && cursorImage.loadFromFile(cursorImagePath)) {
-        cursor.loadFromPixels(cursorImage.getPixelsPtr(), cursorImage.getSize(), { 0, 0 });
+    const auto cursorPixels = cursorImage.get();
+    if (cursorPixels != nullptr) {
+        cursor.loadFromPixels(cursorPixels->getPixelsPtr(), cursorPixels->getSize(), { 0, 0 });
         window.setMouseCursor(cursor);
     }
 
-    if (fontPath != "NONE") {
-        if (!_font.loadFromFile(fontPath)) {
-            Logger::log("Could not load font from " + fontPath);
-        }
+    const auto spriteSheetImage = spriteSheet.get();
+    if (spriteSheetImage == nullptr || !UI::_instance.getSpriteSheet()->loadFromImage(*spriteSheetImage)) {
+        Logger::log("Failed to load UI sprite sheet");
     }
 
+    if (!fontLoaded.get()) {
+        Logger::log("Could not load font from " + fontPath);
+    }
+
+    for (auto& task : startupTasks) {
+        task.get();
+    }
+    markStartupPhase("resourcesLoaded");
+
     gameManager->init();
 
     UI::_instance.createVirtualKeyboard();
+    markStartupPhase("initialized");
 
     mainLoop(resources);
 
@@ -178,14 +219,32 @@ void pe::intern::EngineInstance::mainLoop(GfxResources& gfxResources) {
     sf::Sprite& uiSurfaceSprite = gfxResources.uiSurfaceSprite;
 
     _started = true;
+
+    // Updates run at a fixed rate no matter how fast frames are rendered, so
+    // anything that advances once per update behaves the same at 30, 60 or 144 Hz
+    const sf::Time updateStep = sf::seconds(1.f / (float)std::max(1, updateRate));
+    // If a frame takes too long, drop the backlog instead of trying to catch up forever
+    const sf::Time maxBacklog = updateStep * (float)MAX_UPDATES_PER_FRAME;
+    sf::Time backlog = updateStep;
+    sf::Clock frameClock;
+
     sf::Event event;
     while (window.isOpen()) {
         while (window.pollEvent(event)) {
             handleEvent(event);
         }
+        _inputManager.flushPendingEvents();
+        Gamepad::update();
 
-        UI::_instance.update();
-        gameManager->update();
+        backlog += frameClock.restart();
+        if (backlog > maxBacklog) backlog = maxBacklog;
+
+        while (backlog >= updateStep) {
+            UI::_instance.update();
+            gameManager->update();
+            backlog -= updateStep;
+        }
+        _frameInterpolation = backlog.asSeconds() / updateStep.asSeconds();
 
         mainSurface.setView(camera);
 
@@ -204,6 +263,13 @@ void pe::intern::EngineInstance::mainLoop(GfxResources& gfxResources) {
         window.draw(mainSurfaceSprite);
         window.draw(uiSurfaceSprite);
         window.display();
+
+        if (_timeToFirstFrame == 0) {
+            markStartupPhase("firstFrame");
+            _timeToFirstFrame = _startupTimings.back().millis;
+        }
+
+        _frameArena.reset();
     }
 }
 
@@ -211,13 +277,14 @@ void pe::intern::EngineInstance::shutdown() {
     _started = false;
 
     gameManager->onShutdown();
+    Gamepad::stopVibration();
+
+    // Finishes anything still queued, like an export, before the rest of the engine goes away
+    _taskScheduler.shutdown();
 
     SoundManager::shutdown();
     //SteamAPI_Shutdown();
     Logger::log("SHUTDOWN");
-    while (!Logger::queuesHaveFlushed()) {
-        sf::sleep(sf::milliseconds(500));
-    }
     Logger::stop();
 }
 
@@ -257,3 +324,37 @@ pe::intern::InputEventDistributor& pe::intern::EngineInstance::getInputManager()
 sf::Font& pe::intern::EngineInstance::getFont() {
     return _font;
 }
+
+sf::Time pe::intern::EngineInstance::getElapsedTime() const {
+    return _clock.getElapsedTime();
+}
+
+float pe::intern::EngineInstance::getFrameInterpolation() const {
+    return _frameInterpolation;
+}
+
+pe::FrameArena& pe::intern::EngineInstance::getFrameArena() {
+    return _frameArena;
+}
+
+pe::TaskScheduler& pe::intern::EngineInstance::getTaskScheduler() {
+    return _taskScheduler;
+}
+
+void pe::intern::EngineInstance::addStartupTask(std::function<void()> task) {
+    _startupTasks.push_back(std::move(task));
+}
+
+const std::vector<pe::StartupTiming>& pe::intern::EngineInstance::getStartupTimings() const {
+    return _startupTimings;
+}
+
+double pe::intern::EngineInstance::getTimeToFirstFrame() const {
+    return _timeToFirstFrame;
+}
+
+void pe::intern::EngineInstance::markStartupPhase(const std::string& phase) {
+    const double millis = _startupClock.getElapsedTime().asMicroseconds() / 1000.0;
+    _startupTimings.push_back({ phase, millis });
+    Logger::log("Startup: " + phase + " after " + std::to_string(millis) + " ms");
+}
@@ -4,11 +4,21 @@
 #ifndef _ENGINE_INSTANCE_H
 #define _ENGINE_INSTANCE_H
 
+#include <functional>
+#include <vector>
 #include "GameManager.h"
 #include "Resolution.h"
+#include "FrameArena.h"
+#include "TaskScheduler.h"
 #include "../input/InputEventDistributor.h"
 
 namespace pe {
+    struct StartupTiming {
+        std::string phase;
+        // Time since PennyEngine::start() was called
+        double millis;
+    };
+
     namespace intern {
         struct GfxResources {
             GfxResources(sf::RenderTexture& mainSurface, sf::Sprite& mainSurfaceSprite, sf::RenderTexture& uiSurface, sf::Sprite& uiSurfaceSprite) :
@@ -28,6 +38,7 @@ namespace pe {
 
             sf::RenderWindow window;
             int framerateLimit = 0;
+            int updateRate = 60;
             Resolution renderRes;
             Resolution displayRes;
             bool autoScaleRenderRes = true;
@@ -47,6 +58,19 @@ namespace pe {
 
             std::string fontPath = "NONE";
             sf::Font& getFont();
+
+            sf::Time getElapsedTime() const;
+            float getFrameInterpolation() const;
+
+            FrameArena& getFrameArena();
+
+            TaskScheduler& getTaskScheduler();
+
+            // Runs on its own thread while the window is being created, and is finished before GameManager::init()
+            void addStartupTask(std::function<void()> task);
+            const std::vector<StartupTiming>& getStartupTimings() const;
+            // 0 until the first frame has been shown
+            double getTimeToFirstFrame() const;
         private:
             void createWindow(GfxResources& gfxResources);
             void mainLoop(GfxResources& gfxResources);
@@ -56,11 +80,25 @@ namespace pe {
 
             void connectGamepad();
 
+            void markStartupPhase(const std::string& phase);
+
             bool _started = false;
 
             InputEventDistributor _inputManager;
 
             sf::Font _font;
+
+            sf::Clock _clock;
+            float _frameInterpolation = 0.f;
+
+            FrameArena _frameArena;
+
+            TaskScheduler _taskScheduler;
+
+            std::vector<std::function<void()>> _startupTasks;
+            std::vector<StartupTiming> _startupTimings;
+            sf::Clock _startupClock;
+            double _timeToFirstFrame = 0;
         };
     }
 }
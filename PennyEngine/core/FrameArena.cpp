@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+pe::FrameArena::FrameArena(std::size_t blockSize) {
+    addBlock(blockSize);
+}
+
+void* pe::FrameArena::allocate(std::size_t size, std::size_t alignment) {
+    while (true) {
+        Block& block = _blocks.at(_currentBlock);
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::uintptr_t aligned = (base + _offset + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+        const std::size_t end = (std::size_t)(aligned - base) + size;
+
+        if (end <= block.size) {
+            _offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        _currentBlock++;
+        _offset = 0;
+        if (_currentBlock == _blocks.size()) addBlock(std::max(block.size * 2, size + alignment));
+    }
+}
+
+void pe::FrameArena::reset() {
+    if (_blocks.size() > 1) {
+        const std::size_t capacity = getCapacity();
+        _blocks.clear();
+        addBlock(capacity);
+    }
+
+    _currentBlock = 0;
+    _offset = 0;
+}
+
+std::size_t pe::FrameArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto& block : _blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void pe::FrameArena::addBlock(std::size_t size) {
+    _blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _FRAME_ARENA_H
+#define _FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace pe {
+    constexpr std::size_t DEFAULT_FRAME_ARENA_SIZE = 256 * 1024;
+
+    /*
+        Bump allocator for short-lived data that only has to survive until
+        the end of the current frame. Everything allocated from it is
+        released at once when the engine resets it after each frame, so
+        individual deallocations are free.
+
+        If a frame needs more than the arena holds, extra blocks are
+        allocated and merged into a single larger block on the next reset,
+        so a steady workload stops touching the heap after a few frames.
+    */
+    class FrameArena {
+    public:
+        FrameArena(std::size_t blockSize = DEFAULT_FRAME_ARENA_SIZE);
+
+        void* allocate(std::size_t size, std::size_t alignment);
+        void reset();
+
+        std::size_t getCapacity() const;
+    private:
+        struct Block {
+            std::unique_ptr<unsigned char[]> data;
+            std::size_t size;
+        };
+
+        std::vector<Block> _blocks;
+        std::size_t _currentBlock = 0;
+        std::size_t _offset = 0;
+
+        void addBlock(std::size_t size);
+    };
+
+    // Lets standard containers allocate from a FrameArena, e.g.
+    // std::vector<T, FrameAllocator<T>> temp(FrameAllocator<T>(PennyEngine::getFrameArena()));
+    template<typename T>
+    class FrameAllocator {
+    public:
+        using value_type = T;
+
+        FrameAllocator(FrameArena& arena) : _arena(&arena) {}
+
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U>& other) : _arena(other._arena) {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) {}
+
+        template<typename U>
+        bool operator==(const FrameAllocator<U>& other) const {
+            return _arena == other._arena;
+        }
+
+        template<typename U>
+        bool operator!=(const FrameAllocator<U>& other) const {
+            return _arena != other._arena;
+        }
+
+        template<typename U>
+        friend class FrameAllocator;
+    private:
+        FrameArena* _arena;
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
+
+#endif
\ No newline at end of file
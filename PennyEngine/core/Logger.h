@@ -7,6 +7,8 @@
 #include <string>
 #include <queue>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
@@ -39,13 +41,20 @@ namespace pe {
                 std::cout << "Logging error: " << ex.what() << std::endl;
             }
 
-            std::thread loggingThread(Logger::run);
-            loggingThread.detach();
+            // The writer lives as long as the engine, so it has its own thread rather than holding a task scheduler worker
+            _thread = std::thread(Logger::run);
         }
 
+        // Writes out anything still queued before closing the log file
         static void stop() {
+            {
+                std::lock_guard<std::mutex> lock(_queueMutex);
+                _isHalted = true;
+            }
+            _wake.notify_all();
+            if (_thread.joinable()) _thread.join();
+
             _isStarted = false;
-            _isHalted = true;
             _outStream.close();
         }
 
@@ -61,8 +70,9 @@ namespace pe {
 
             message = "(" + timeString + (std::string)") " + message;
 
-            if (!_isWriting) _messageQueue.push(message);
-            else _deferredMessageQueue.push(message);
+            // Messages can come from worker threads as well as the main thread
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _messageQueue.push(message);
         }
 
         static void log(int message) {
@@ -97,40 +107,38 @@ namespace pe {
             return _logFileName;
         }
 
-        static bool queuesHaveFlushed() {
-            return _messageQueue.empty() && _deferredMessageQueue.empty();
-        }
-
     private:
         inline static std::queue<std::string> _messageQueue;
-        inline static std::queue<std::string> _deferredMessageQueue;
+        inline static std::mutex _queueMutex;
+        inline static std::condition_variable _wake;
+        inline static std::thread _thread;
 
         inline static bool _isStarted = false;
         inline static bool _isHalted = false;
-        inline static bool _isWriting = false;
 
         inline static std::string _logFileName = "PennyEngine.log";
         inline static std::ofstream _outStream;
 
         static void run() {
-            while (!_isHalted) {
-                std::this_thread::sleep_for(std::chrono::milliseconds((int)(LOG_WRITE_INTERVAL_SECONDS * 1000.f)));
+            bool halted = false;
+            while (!halted) {
+                // The lock is only held to wait and to take the queued messages, so log() never waits on the disk
+                std::queue<std::string> messages;
+                {
+                    std::unique_lock<std::mutex> lock(_queueMutex);
+                    // stop() wakes this early. Everything queued before it halted is taken in the same
+                    // locked section, so the last messages are written before the file closes
+                    _wake.wait_for(lock, std::chrono::milliseconds((int)(LOG_WRITE_INTERVAL_SECONDS * 1000.f)), []() { return _isHalted; });
+                    std::swap(messages, _messageQueue);
+                    halted = _isHalted;
+                }
 
-                _isWriting = true;
                 try {
-                    while (!_messageQueue.empty()) {
-                        _outStream << _messageQueue.front() << std::endl;
-                        _messageQueue.pop();
+                    while (!messages.empty()) {
+                        _outStream << messages.front() << '\n';
+                        messages.pop();
                     }
-                    _isWriting = false;
-
-                    while (!_deferredMessageQueue.empty()) {
-                        _outStream << _deferredMessageQueue.front() << std::endl;
-                        _deferredMessageQueue.pop();
-                    }
-
                     _outStream.flush();
-
                 } catch (std::exception ex) {
                     std::cout << "Logging error: " << ex.what() << std::endl;
                 }
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _OBJECT_POOL_H
+#define _OBJECT_POOL_H
+
+#include <cstddef>
+#include <new>
+
+namespace pe {
+    namespace intern {
+        // Free list of fixed-size slots, carved out of slabs that are never
+        // freed, so objects that are still alive during static destruction
+        // (like the nodes in VisualTree) don't outlive their memory.
+        // One pool exists per slot size.
+        template<std::size_t SlotSize, std::size_t SlotAlignment>
+        class ObjectPool {
+        public:
+            static void* acquire() {
+                if (_freeList == nullptr) grow();
+
+                Slot* slot = _freeList;
+                _freeList = slot->next;
+                return slot;
+            }
+
+            static void release(void* p) {
+                Slot* slot = static_cast<Slot*>(p);
+                slot->next = _freeList;
+                _freeList = slot;
+            }
+        private:
+            union alignas(SlotAlignment) Slot {
+                Slot* next;
+                unsigned char storage[SlotSize];
+            };
+
+            static constexpr std::size_t SLOTS_PER_SLAB = 256;
+
+            static inline Slot* _freeList = nullptr;
+
+            static void grow() {
+                Slot* slab = new Slot[SLOTS_PER_SLAB];
+                for (std::size_t i = 0; i < SLOTS_PER_SLAB; i++) {
+                    release(&slab[i]);
+                }
+            }
+        };
+    }
+
+    /*
+        Allocator that hands out single objects from a pool instead of the
+        heap. Meant for std::allocate_shared, which puts the object and its
+        control block into one pooled slot:
+
+        s_p<T> object = std::allocate_shared<T>(pe::PoolAllocator<T>(), args...);
+
+        Not thread-safe; pooled objects should only be created and destroyed
+        on the main thread.
+    */
+    template<typename T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        PoolAllocator() = default;
+
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>& other) {}
+
+        T* allocate(std::size_t n) {
+            if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(intern::ObjectPool<sizeof(T), alignof(T)>::acquire());
+        }
+
+        void deallocate(T* p, std::size_t n) {
+            if (n != 1) ::operator delete(p);
+            else intern::ObjectPool<sizeof(T), alignof(T)>::release(p);
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U>& other) const {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const PoolAllocator<U>& other) const {
+            return false;
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "TaskScheduler.h"
+#include <algorithm>
+
+pe::TaskScheduler::~TaskScheduler() {
+    shutdown();
+}
+
+void pe::TaskScheduler::start(unsigned int threadCount) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_workers.empty() && !_stopped) startWorkers(threadCount);
+}
+
+void pe::TaskScheduler::startWorkers(unsigned int threadCount) {
+    // hardware_concurrency() is 0 when it can't be detected
+    if (threadCount == 0) threadCount = std::max(3u, std::thread::hardware_concurrency()) - 1;
+
+    _workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _workers.emplace_back(&TaskScheduler::run, this);
+    }
+}
+
+void pe::TaskScheduler::shutdown() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopped) return;
+        _stopped = true;
+        workers = std::move(_workers);
+        _workers.clear();
+    }
+    _wake.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int pe::TaskScheduler::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (unsigned int)_workers.size();
+}
+
+void pe::TaskScheduler::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _stopped || !_tasks.empty(); });
+            // Queued tasks are finished before stopping, so nothing waiting on a future is left hanging
+            if (_tasks.empty()) return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
\ No newline at end of file
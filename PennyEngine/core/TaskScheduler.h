@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _TASK_SCHEDULER_H
+#define _TASK_SCHEDULER_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace pe {
+    /*
+        A fixed set of worker threads shared by everything that needs to
+        run in the background (decoding, encoding, file I/O), so work
+        doesn't start threads of its own.
+
+        submit() returns a future for the task's result; exceptions thrown
+        by the task are rethrown from future::get(). The workers start with
+        the engine, or on the first submit() if that comes first. On
+        shutdown, tasks that are already queued are finished before the
+        workers are joined, and anything submitted after that runs on the
+        calling thread.
+
+        Tasks shouldn't wait on other tasks, since they could be queued
+        behind the one that's waiting.
+    */
+    class TaskScheduler {
+    public:
+        ~TaskScheduler();
+
+        // threadCount 0 uses one less than the number of hardware threads, but at least 2
+        void start(unsigned int threadCount = 0);
+        void shutdown();
+
+        unsigned int getThreadCount() const;
+
+        template <typename Task>
+        std::future<std::invoke_result_t<Task>> submit(Task&& task) {
+            using Result = std::invoke_result_t<Task>;
+
+            const auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+            std::future<Result> result = packaged->get_future();
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (!_stopped) {
+                    if (_workers.empty()) startWorkers(0);
+                    _tasks.push([packaged]() { (*packaged)(); });
+                    lock.unlock();
+                    _wake.notify_one();
+                    return result;
+                }
+            }
+
+            (*packaged)();
+            return result;
+        }
+    private:
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+
+        // Guards _tasks, _workers and _stopped
+        mutable std::mutex _mutex;
+        std::condition_variable _wake;
+        bool _stopped = false;
+
+        // Call with _mutex held
+        void startWorkers(unsigned int threadCount);
+        void run();
+    };
+}
+
+#endif
\ No newline at end of file
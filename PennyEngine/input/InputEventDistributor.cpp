@@ -4,49 +4,60 @@
 #include "InputEventDistributor.h"
 #include "Gamepad/Gamepad.h"
 #include "../PennyEngine.h"
+#include <algorithm>
 
 void pe::intern::InputEventDistributor::handleEvent(sf::Event& event) {
+    if (event.type == sf::Event::MouseMoved) {
+        if (!_hasPendingMove) _scrollIsFirst = _hasPendingScroll;
+        _hasPendingMove = true;
+        _pendingMove = event.mouseMove;
+        return;
+    } else if (event.type == sf::Event::MouseWheelScrolled) {
+        // Scrolling a different wheel can't be merged, so the earlier scroll goes out first
+        if (_hasPendingScroll && _pendingScroll.wheel != event.mouseWheelScroll.wheel) flushPendingEvents();
+
+        if (_hasPendingScroll) {
+            const float delta = _pendingScroll.delta + event.mouseWheelScroll.delta;
+            _pendingScroll = event.mouseWheelScroll;
+            _pendingScroll.delta = delta;
+        } else {
+            _scrollIsFirst = !_hasPendingMove;
+            _hasPendingScroll = true;
+            _pendingScroll = event.mouseWheelScroll;
+        }
+        return;
+    }
+
+    // Everything else has to see the mouse where it was when it happened
+    flushPendingEvents();
+
     switch (event.type) {
         case sf::Event::TextEntered: 
         {
-            for (const auto& listener : _keyListeners) listener->textEntered(event.text.unicode);
+            dispatch(_keyListeners, true, [&](KeyListener* listener) { listener->textEntered(event.text.unicode); });
             break;
         }
         case sf::Event::KeyPressed:
         {
-            for (const auto& listener : _keyListeners) listener->keyPressed(event.key.code);
+            dispatch(_keyListeners, true, [&](KeyListener* listener) { listener->keyPressed(event.key.code); });
             break;
         }
         
         case sf::Event::KeyReleased:
         {
-            for (const auto& listener : _keyListeners) listener->keyReleased(event.key.code);
+            dispatch(_keyListeners, false, [&](KeyListener* listener) { listener->keyReleased(event.key.code); });
             break;
         }
 
         case sf::Event::MouseButtonPressed:
         {
-            for (const auto& listener : _mouseListeners) listener->mouseButtonPressed(event.mouseButton.x, event.mouseButton.y, event.mouseButton.button);
+            dispatch(_mouseListeners, true, [&](MouseListener* listener) { listener->mouseButtonPressed(event.mouseButton.x, event.mouseButton.y, event.mouseButton.button); });
             break;
         }
 
         case sf::Event::MouseButtonReleased:
         {
-            for (const auto& listener : _mouseListeners) listener->mouseButtonReleased(event.mouseButton.x, event.mouseButton.y, event.mouseButton.button);
-            break;
-        }
-
-        case sf::Event::MouseMoved:
-        {
-            PennyEngine::getWindow().setMouseCursorVisible(true);
-            PennyEngine::_usingMouse = true;
-            for (const auto& listener : _mouseListeners) listener->mouseMoved(event.mouseMove.x, event.mouseMove.y);
-            break;
-        }
-
-        case sf::Event::MouseWheelScrolled:
-        {
-            for (const auto& listener : _mouseListeners) listener->mouseWheelScrolled(event.mouseWheelScroll);
+            dispatch(_mouseListeners, false, [&](MouseListener* listener) { listener->mouseButtonReleased(event.mouseButton.x, event.mouseButton.y, event.mouseButton.button); });
             break;
         }
 
@@ -74,13 +85,39 @@ void pe::intern::InputEventDistributor::handleEvent(sf::Event& event) {
     }
 }
 
-void pe::intern::InputEventDistributor::addListener(InputListener* listener) {
+void pe::intern::InputEventDistributor::flushPendingEvents() {
+    if (_scrollIsFirst) {
+        dispatchMouseWheelScroll();
+        dispatchMouseMove();
+    } else {
+        dispatchMouseMove();
+        dispatchMouseWheelScroll();
+    }
+}
+
+void pe::intern::InputEventDistributor::dispatchMouseMove() {
+    if (!_hasPendingMove) return;
+    _hasPendingMove = false;
+
+    PennyEngine::getWindow().setMouseCursorVisible(true);
+    PennyEngine::_usingMouse = true;
+    dispatch(_mouseListeners, false, [&](MouseListener* listener) { listener->mouseMoved(_pendingMove.x, _pendingMove.y); });
+}
+
+void pe::intern::InputEventDistributor::dispatchMouseWheelScroll() {
+    if (!_hasPendingScroll) return;
+    _hasPendingScroll = false;
+
+    dispatch(_mouseListeners, true, [&](MouseListener* listener) { listener->mouseWheelScrolled(_pendingScroll); });
+}
+
+void pe::intern::InputEventDistributor::addListener(InputListener* listener, int priority) {
     if (listener->_isKeyListener) {
-        _keyListeners.push_back(dynamic_cast<KeyListener*>(listener));
+        insertListener(_keyListeners, dynamic_cast<KeyListener*>(listener), priority);
     }
 
     if (listener->_isMouseListener) {
-        _mouseListeners.push_back(dynamic_cast<MouseListener*>(listener));
+        insertListener(_mouseListeners, dynamic_cast<MouseListener*>(listener), priority);
     }
 
     if (listener->_isGamepadListener) {
@@ -88,6 +125,25 @@ void pe::intern::InputEventDistributor::addListener(InputListener* listener) {
     }
 }
 
+template<typename Listener>
+void pe::intern::InputEventDistributor::insertListener(std::vector<PrioritizedListener<Listener>>& listeners, Listener* listener, int priority) {
+    const auto it = std::find_if(listeners.begin(), listeners.end(), [priority](const PrioritizedListener<Listener>& other) {
+        return other.priority < priority;
+    });
+    listeners.insert(it, { listener, priority });
+}
+
+template<typename Listener, typename Handler>
+void pe::intern::InputEventDistributor::dispatch(const std::vector<PrioritizedListener<Listener>>& listeners, bool consumable, Handler handler) {
+    for (const auto& entry : listeners) {
+        handler(entry.listener);
+
+        const bool consumed = entry.listener->_consumedEvent;
+        entry.listener->_consumedEvent = false;
+        if (consumed && consumable) return;
+    }
+}
+
 void pe::intern::InputEventDistributor::setUIMouseOffset(sf::Vector2f offset) {
     _uiMouseOffset = offset;
 }
@@ -15,16 +15,41 @@ namespace pe {
         class InputEventDistributor {
         public:
             void handleEvent(sf::Event& event);
+            // Sends out the mouse move and wheel events held back from the last batch of polled events
+            void flushPendingEvents();
 
-            void addListener(InputListener* listener);
+            // Higher priority listeners get events first; listeners with the same priority keep the order they were added in
+            void addListener(InputListener* listener, int priority = 0);
 
             void setUIMouseOffset(sf::Vector2f offset);
             sf::Vector2f getUIMouseOffset() const;
         private:
-            std::vector<KeyListener*> _keyListeners;
-            std::vector<MouseListener*> _mouseListeners;
+            template<typename Listener>
+            struct PrioritizedListener {
+                Listener* listener;
+                int priority;
+            };
+
+            std::vector<PrioritizedListener<KeyListener>> _keyListeners;
+            std::vector<PrioritizedListener<MouseListener>> _mouseListeners;
+
+            template<typename Listener>
+            static void insertListener(std::vector<PrioritizedListener<Listener>>& listeners, Listener* listener, int priority);
+            template<typename Listener, typename Handler>
+            static void dispatch(const std::vector<PrioritizedListener<Listener>>& listeners, bool consumable, Handler handler);
 
             sf::Vector2f _uiMouseOffset;
+
+            // Moves and wheel scrolls are merged until something else happens or the poll batch ends,
+            // so fast mice don't send every listener dozens of events a frame
+            bool _hasPendingMove = false;
+            sf::Event::MouseMoveEvent _pendingMove;
+            bool _hasPendingScroll = false;
+            sf::Event::MouseWheelScrollEvent _pendingScroll;
+            bool _scrollIsFirst = false;
+
+            void dispatchMouseMove();
+            void dispatchMouseWheelScroll();
         };
     }
 }
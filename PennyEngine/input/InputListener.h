@@ -5,6 +5,9 @@
 #define _INPUT_LISTENER_H
 
 namespace pe {
+    // Menus sit above everything else, so they see input first
+    constexpr int UI_INPUT_PRIORITY = 100;
+
     namespace intern {
         class InputListener {
         public:
@@ -14,11 +17,19 @@ namespace pe {
             bool _isMouseListener = false;
             bool _isGamepadListener = false;
 
+            // Stops the key press, text, mouse press or wheel scroll being handled from reaching lower priority listeners.
+            // Moves and releases always reach everyone, since listeners keep their hover and button state from them
+            void consumeEvent() {
+                _consumedEvent = true;
+            }
+
             virtual void listenToAll() {
                 _isKeyListener = true;
                 _isMouseListener = true;
                 _isGamepadListener = true;
             };
+        private:
+            bool _consumedEvent = false;
         };
     }
 }
@@ -5,7 +5,6 @@
 #include <SFML/Window/Joystick.hpp>
 #include <windows.h>
 #include <Xinput.h>
-#include <thread>
 #include "../../core/Logger.h"
 #include "GamepadListener.h"
 
@@ -38,10 +37,9 @@ unsigned int pe::Gamepad::getProductId() {
 
 void pe::Gamepad::vibrate(int vibrationAmount, long long time) {
     if (_isVibrating || _pid == DUALSENSE_PID /* || (!STEAMAPI_INITIATED && _vid == SONY_VID)*/) return;
-    vibrationAmount = std::min(MAX_CONTROLLER_VIBRATION, vibrationAmount);
     _isVibrating = true;
-    std::thread vibrateThread(&pe::Gamepad::runVibration, vibrationAmount, time);
-    vibrateThread.detach();
+    _vibrationEndTime = currentTimeMillis() + time;
+    setMotorSpeed(std::min(MAX_CONTROLLER_VIBRATION, vibrationAmount));
 }
 
 float pe::Gamepad::getLeftStickXAxis() {
@@ -136,20 +134,22 @@ void pe::Gamepad::addListener(GamepadListener* listener) {
     _listeners.push_back(listener);
 }
 
-void pe::Gamepad::runVibration(int vibrationAmount, long long time) {
+void pe::Gamepad::setMotorSpeed(int speed) {
     XINPUT_VIBRATION vibration;
     ZeroMemory(&vibration, sizeof(XINPUT_VIBRATION));
-    vibration.wLeftMotorSpeed = vibrationAmount;
-    vibration.wRightMotorSpeed = vibrationAmount;
+    vibration.wLeftMotorSpeed = speed;
+    vibration.wRightMotorSpeed = speed;
     XInputSetState(0, &vibration);
+}
 
-    Sleep(time);
-
-    vibration.wLeftMotorSpeed = 0;
-    vibration.wRightMotorSpeed = 0;
-    XInputSetState(0, &vibration);
+void pe::Gamepad::update() {
+    if (_isVibrating && currentTimeMillis() >= _vibrationEndTime) stopVibration();
+}
 
+void pe::Gamepad::stopVibration() {
+    if (!_isVibrating) return;
     _isVibrating = false;
+    setMotorSpeed(0);
 }
 
 float pe::Gamepad::removeDeadZone(float axisValue) {
@@ -10,6 +10,10 @@
 #include <SFML/Window/Event.hpp>
 
 namespace pe {
+    namespace intern {
+        class EngineInstance;
+    }
+
     constexpr unsigned int SONY_VID = 0x054C;
     constexpr unsigned int DUALSENSE_PID = 0x0CE6;
 
@@ -44,6 +48,7 @@ namespace pe {
         static bool isConnected();
 
         friend class pe::intern::InputEventDistributor;
+        friend class pe::intern::EngineInstance;
     private:
         inline static unsigned int _id = 0;
 
@@ -63,8 +68,12 @@ namespace pe {
         inline static bool _triggerIsPressed[(int)GAMEPAD_BUTTON::DPAD_RIGHT - (int)GAMEPAD_BUTTON::LEFT_TRIGGER + 1];
 
         inline static bool _isVibrating = false;
+        inline static long long _vibrationEndTime = 0;
 
-        static void runVibration(int vibrationAmount, long long time);
+        static void setMotorSpeed(int speed);
+        // Called every frame by the engine, and stops the motors once the vibration's time is up
+        static void update();
+        static void stopVibration();
 
         static float removeDeadZone(float axisValue);
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License. See LICENSE file.
 
 #include "Menu.h"
+#include <algorithm>
 #include <SFML/Graphics/RenderTexture.hpp>
 #include "../PennyEngine.h"
 #include "../core/Logger.h"
@@ -9,7 +10,7 @@
 pe::Menu::Menu(const std::string id) : _id(id) {}
 
 void pe::Menu::update() {
-    sortComponents();
+    if (!_pendingZMoves.empty()) applyZMoves();
 
     for (auto& component : _components) {
         if (component->isActive()) component->update();
@@ -38,16 +39,15 @@ void pe::Menu::draw(sf::RenderTexture& surface) {
 }
 
 void pe::Menu::addComponent(s_p<MenuComponent> component) {
-    _components.push_back(component);
+    // Components added later sit behind the ones added before them
+    _components.insert(_components.begin(), component);
+    _componentLookup.emplace(component->getIdentifier(), component);
     component->_parentMenus.push_back(this);
-    component->_zPositions[getIdentifier()] = _componentZTracker;
-    _componentZTracker++;
 }
 
-s_p<pe::MenuComponent> pe::Menu::getComponent(std::string id, bool suppressWarning) const {
-    for (const auto& component : _components) {
-        if (component->getIdentifier() == id) return component;
-    }
+s_p<pe::MenuComponent> pe::Menu::getComponent(const std::string& id, bool suppressWarning) const {
+    const auto it = _componentLookup.find(id);
+    if (it != _componentLookup.end()) return it->second;
 
     if (!suppressWarning) {
         Logger::log("Did not find menu component with id \"" + id + "\"");
@@ -55,75 +55,76 @@ s_p<pe::MenuComponent> pe::Menu::getComponent(std::string id, bool suppressWarni
     return nullptr;
 }
 
-std::vector<s_p<pe::MenuComponent>> pe::Menu::getComponents() const {
+const std::vector<s_p<pe::MenuComponent>>& pe::Menu::getComponents() const {
     return _components;
 }
 
 void pe::Menu::clearComponents() {
     _components.clear();
+    _componentLookup.clear();
+    _pendingZMoves.clear();
+}
+
+void pe::Menu::setFactory(std::function<void(Menu&)> factory, bool releaseWhenIdle) {
+    _factory = std::move(factory);
+    _releaseWhenIdle = releaseWhenIdle;
+    _built = false;
+    if (_isActive) build();
+}
+
+bool pe::Menu::isBuilt() const {
+    return _built;
+}
+
+void pe::Menu::build() {
+    _built = true;
+    _factory(*this);
+}
+
+void pe::Menu::releaseIfIdle(sf::Time now) {
+    if (!_releaseWhenIdle || !_built || _isActive || now - _closedAt < sf::seconds(MENU_IDLE_RELEASE_SECONDS)) return;
+
+    clearComponents();
+    _selectionGrid.clear();
+    _useGamepadConfig = false;
+    _built = false;
 }
 
 void pe::Menu::moveForward(MenuComponent* component) {
-    if (component->_zPositions.at(getIdentifier()) == 0) return;
-    component->_zPositions.at(getIdentifier())--;
-
-    sortComponents();
-    for (int i = getComponents().size() - 1; i >= 0; i--) {
-        const auto& otherComponent = _components.at(i);
-        if (otherComponent->getIdentifier() != component->getIdentifier()) {
-            if (otherComponent->_zPositions.at(getIdentifier()) == component->_zPositions.at(getIdentifier())) {
-                otherComponent->_zPositions.at(getIdentifier())++;
-                return;
-            }
-        }
-    }
+    _pendingZMoves.push_back({ component, Z_MOVE::FORWARD });
 }
 
 void pe::Menu::moveBack(MenuComponent* component) {
-    component->_zPositions.at(getIdentifier())++;
-
-    sortComponents();
-    for (int i = 0; i < getComponents().size(); i++) {
-        const auto& otherComponent = _components.at(i);
-        if (otherComponent->getIdentifier() != component->getIdentifier()) {
-            if (otherComponent->_zPositions.at(getIdentifier()) == component->_zPositions.at(getIdentifier())) {
-                otherComponent->_zPositions.at(getIdentifier())--;
-                return;
-            }
-        }
-    }
+    _pendingZMoves.push_back({ component, Z_MOVE::BACK });
 }
 
 void pe::Menu::moveToFront(MenuComponent* component) {
-    if (component->_zPositions.at(getIdentifier()) == 0) return;
-    sortComponents();
-
-    for (int i = 0; i < getComponents().size(); i++) {
-        const auto& otherComponent = _components.at(i);
-        if (otherComponent->getIdentifier() != component->getIdentifier()) {
-            if (otherComponent->_zPositions.at(getIdentifier()) > component->_zPositions.at(getIdentifier())) {
-                otherComponent->_zPositions.at(getIdentifier())--;
-            }
-        } else break;
-    }
+    _pendingZMoves.push_back({ component, Z_MOVE::TO_FRONT });
+}
 
-    component->_zPositions.at(getIdentifier()) = 0;
-    if (_components.at(_components.size() - 1)->_zPositions.at(getIdentifier()) == 0) {
-        for (int i = getComponents().size() - 1; i >= 0; i--) {
-            const auto& otherComponent = _components.at(i);
-            if (otherComponent->getIdentifier() != component->getIdentifier()) {
-                otherComponent->_zPositions.at(getIdentifier())++;
+void pe::Menu::applyZMoves() {
+    for (const auto& [component, zMove] : _pendingZMoves) {
+        const auto it = std::find_if(_components.begin(), _components.end(),
+            [component](const s_p<MenuComponent>& otherComponent) {
+                return otherComponent.get() == component;
             }
+        );
+        if (it == _components.end()) continue;
+
+        switch (zMove) {
+            case Z_MOVE::FORWARD:
+                if (it + 1 != _components.end()) std::iter_swap(it, it + 1);
+                break;
+            case Z_MOVE::BACK:
+                if (it != _components.begin()) std::iter_swap(it, it - 1);
+                break;
+            case Z_MOVE::TO_FRONT:
+                std::rotate(it, it + 1, _components.end());
+                break;
         }
     }
-}
 
-void pe::Menu::sortComponents() {
-    std::sort(_components.begin(), _components.end(),
-        [this](s_p<MenuComponent> component0, s_p<MenuComponent> component1) {
-            return component0->_zPositions.at(getIdentifier()) > component1->_zPositions.at(getIdentifier());
-        }
-    );
+    _pendingZMoves.clear();
 }
 
 void pe::Menu::addChild(s_p<Menu> menu) {
@@ -140,7 +141,7 @@ s_p<pe::Menu> pe::Menu::getChild(std::string id) const {
     return nullptr;
 }
 
-std::vector<s_p<pe::Menu>> pe::Menu::getChildren() const {
+const std::vector<s_p<pe::Menu>>& pe::Menu::getChildren() const {
     return _children;
 }
 
@@ -154,6 +155,8 @@ pe::Menu* pe::Menu::getParent() const {
 }
 
 void pe::Menu::open(bool closeParents) {
+    if (!_built) build();
+
     _isActive = true;
     _pendingActivation = true;
 
@@ -168,6 +171,7 @@ void pe::Menu::open(bool closeParents) {
 }
 
 void pe::Menu::close(bool openParent) {
+    if (_isActive) _closedAt = PennyEngine::getElapsedTime();
     _isActive = false;
     for (auto& component : _components) {
         component->hide();
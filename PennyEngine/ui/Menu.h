@@ -9,6 +9,9 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include "components/MenuComponent.h"
+#include <unordered_map>
+#include <functional>
+#include <SFML/System/Time.hpp>
 #include "../core/Defines.h"
 
 namespace pe {
@@ -18,6 +21,9 @@ namespace pe {
 }
 
 namespace pe {
+    // How long a menu with releaseWhenIdle set has to stay closed before its components are destroyed
+    constexpr float MENU_IDLE_RELEASE_SECONDS = 60.f;
+
     class Menu {
     public:
         Menu(const std::string id);
@@ -26,17 +32,24 @@ namespace pe {
         void draw(sf::RenderTexture& surface);
 
         void addComponent(s_p<MenuComponent> component);
-        s_p<MenuComponent> getComponent(std::string id, bool suppressWarning = false) const;
-        std::vector<s_p<MenuComponent>> getComponents() const;
+        s_p<MenuComponent> getComponent(const std::string& id, bool suppressWarning = false) const;
+        const std::vector<s_p<MenuComponent>>& getComponents() const;
         void clearComponents();
 
+        // Defers adding the menu's components until it's first opened, for menus that are rarely used.
+        // With releaseWhenIdle, they're destroyed again once the menu has been closed for a while, and
+        // rebuilt the next time it opens, so the factory should set up any state it needs from scratch
+        void setFactory(std::function<void(Menu&)> factory, bool releaseWhenIdle = false);
+        // False if the menu has a factory that hasn't run yet (or its components have been released)
+        bool isBuilt() const;
+
         void moveForward(MenuComponent* component);
         void moveBack(MenuComponent* component);
         void moveToFront(MenuComponent* component);
 
         void addChild(s_p<Menu> menu);
         s_p<Menu> getChild(std::string id) const;
-        std::vector<s_p<Menu>> getChildren() const;
+        const std::vector<s_p<Menu>>& getChildren() const;
 
         Menu* getParent() const;
         bool hasParent() const;
@@ -67,8 +80,18 @@ namespace pe {
         bool _hasParent = false;
         Menu* _parent = nullptr;
 
+        // Kept in draw order, back to front, so no sorting is needed each frame
         std::vector<s_p<MenuComponent>> _components;
-        unsigned int _componentZTracker = 0;
+        std::unordered_map<std::string, s_p<MenuComponent>> _componentLookup;
+
+        enum class Z_MOVE {
+            FORWARD,
+            BACK,
+            TO_FRONT
+        };
+        // Z-order changes requested while the menu is handling input are applied
+        // on the next update so _components isn't reordered mid-iteration
+        std::vector<std::pair<MenuComponent*, Z_MOVE>> _pendingZMoves;
 
         std::vector<s_p<Menu>> _children;
 
@@ -78,7 +101,16 @@ namespace pe {
 
         bool _pendingActivation = false;
 
-        void sortComponents();
+        std::function<void(Menu&)> _factory;
+        bool _built = true;
+        bool _releaseWhenIdle = false;
+        sf::Time _closedAt;
+
+        void build();
+        // Called by UIManager while the menu is closed
+        void releaseIfIdle(sf::Time now);
+
+        void applyZMoves();
 
         void controllerButtonReleased(GAMEPAD_BUTTON button);
         void controllerButtonPressed(GAMEPAD_BUTTON button);
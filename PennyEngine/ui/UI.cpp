@@ -41,21 +41,15 @@ void pe::UI::toggleVirtualKeyboard() {
     _instance.toggleVirtualKeyboard();
 }
 
-s_p<pe::Menu> pe::UI::addMenu(std::string id) {
-    _instance.getMenus().push_back(new_s_p(Menu, (id)));
-    return getMenu(id);
+s_p<pe::Menu> pe::UI::addMenu(const std::string& id) {
+    return _instance.addMenu(id);
 }
 
-s_p<pe::Menu> pe::UI::getMenu(std::string id) {
-    for (const auto& menu : _instance.getMenus()) {
-        if (menu->getIdentifier() == id) return menu;
-    }
-
-    Logger::log("Did not find menu with id \"" + id + "\"");
-    return nullptr;
+s_p<pe::Menu> pe::UI::getMenu(const std::string& id) {
+    return _instance.getMenu(id);
 }
 
-std::vector<s_p<pe::Menu>> pe::UI::getMenus() {
+const std::vector<s_p<pe::Menu>>& pe::UI::getMenus() {
     return _instance.getMenus();
 }
 
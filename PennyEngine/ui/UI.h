@@ -31,9 +31,9 @@ namespace pe {
             _instance.getSurface()->draw(graphic);
         }
 
-        static s_p<Menu> addMenu(std::string id);
-        static s_p<Menu> getMenu(std::string id); 
-        static std::vector<s_p<Menu>> getMenus();
+        static s_p<Menu> addMenu(const std::string& id);
+        static s_p<Menu> getMenu(const std::string& id); 
+        static const std::vector<s_p<Menu>>& getMenus();
 
         static s_p<sf::Texture> getSpriteSheet();
 
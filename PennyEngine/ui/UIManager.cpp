@@ -9,16 +9,15 @@
 #include "components/Panel.h"
 
 pe::intern::UIManager::UIManager() {
-    PennyEngine::addInputListener(this);
-
-    if (!_spriteSheet->loadFromFile("res/ui_sprite_sheet.png")) {
-        Logger::log("Failed to load UI sprite sheet");
-    }
+    // The sprite sheet is decoded while the window is created, and uploaded by EngineInstance::start()
+    PennyEngine::addInputListener(this, UI_INPUT_PRIORITY);
 }
 
 void pe::intern::UIManager::update() {
+    const sf::Time now = PennyEngine::getElapsedTime();
     for (const auto& menu : getMenus()) {
         if (menu->isActive()) menu->update();
+        else menu->releaseIfIdle(now);
     }
 }
 
@@ -30,7 +29,22 @@ void pe::intern::UIManager::draw() {
     }
 }
 
-std::vector<s_p<pe::Menu>>& pe::intern::UIManager::getMenus() {
+s_p<pe::Menu> pe::intern::UIManager::addMenu(const std::string& id) {
+    const auto& menu = new_s_p(Menu, (id));
+    _menus.push_back(menu);
+    _menuLookup.emplace(id, menu);
+    return menu;
+}
+
+s_p<pe::Menu> pe::intern::UIManager::getMenu(const std::string& id) const {
+    const auto it = _menuLookup.find(id);
+    if (it != _menuLookup.end()) return it->second;
+
+    Logger::log("Did not find menu with id \"" + id + "\"");
+    return nullptr;
+}
+
+const std::vector<s_p<pe::Menu>>& pe::intern::UIManager::getMenus() const {
     return _menus;
 }
 
@@ -69,6 +83,8 @@ void pe::intern::UIManager::mouseButtonPressed(const int mx, const int my, const
     for (const auto& menu : getMenus()) {
         if (menu->isActive()) menu->mouseButtonPressed(mx + mouseOffset.x, my + mouseOffset.y, button);
     }
+
+    if (isOverMenu(mx + mouseOffset.x, my + mouseOffset.y)) consumeEvent();
 }
 
 void pe::intern::UIManager::mouseButtonReleased(const int mx, const int my, const int button) {
@@ -89,6 +105,20 @@ void pe::intern::UIManager::mouseWheelScrolled(sf::Event::MouseWheelScrollEvent
     for (const auto& menu : getMenus()) {
         if (menu->isActive()) menu->mouseWheelScrolled(mouseWheelScroll);
     }
+
+    const sf::Vector2f mouseOffset = PennyEngine::getUIMouseOffset();
+    if (isOverMenu(mouseWheelScroll.x + mouseOffset.x, mouseWheelScroll.y + mouseOffset.y)) consumeEvent();
+}
+
+bool pe::intern::UIManager::isOverMenu(float x, float y) const {
+    for (const auto& menu : getMenus()) {
+        if (!menu->isActive()) continue;
+
+        for (const auto& component : menu->getComponents()) {
+            if (component->isActive() && component->getBounds().contains(x, y)) return true;
+        }
+    }
+    return false;
 }
 
 void pe::intern::UIManager::controllerButtonReleased(GAMEPAD_BUTTON button) {
@@ -126,6 +156,12 @@ void pe::intern::UIManager::gamepadConnected() {
 }
 
 void pe::intern::UIManager::createVirtualKeyboard() {
+    // Hardly anyone types with a gamepad, so the keys aren't made until the keyboard is opened
+    UI::addMenu("virtKeyboard_lower")->setFactory([this](Menu& keyboard) { buildVirtualKeyboard(keyboard, false); }, true);
+    UI::addMenu("virtKeyboard_upper")->setFactory([this](Menu& keyboard) { buildVirtualKeyboard(keyboard, true); }, true);
+}
+
+void pe::intern::UIManager::buildVirtualKeyboard(Menu& keyboard, bool upperCase) {
     constexpr int rowWidth = 13;
     constexpr float keyWidth = 3.f;
     constexpr float keyHeight = 3.f;
@@ -140,8 +176,8 @@ void pe::intern::UIManager::createVirtualKeyboard() {
     const std::string row3_lower = "§ zxcvbnm,./ ";
     const std::string row3_upper = "§ ZXCVBNM<>? ";
 
-    const std::vector<std::string> lowerRows = { row0_lower, row1_lower, row2_lower, row3_lower };
-    const std::vector<std::string> upperRows = { row0_upper, row1_upper, row2_upper, row3_upper };
+    const std::vector<std::string> rows = upperCase ?
+        std::vector<std::string>{ row0_upper, row1_upper, row2_upper, row3_upper } : std::vector<std::string>{ row0_lower, row1_lower, row2_lower, row3_lower };
 
     constexpr float keyboardX = 50.f - (rowWidth * (keyWidth + keyPadding)) / 2.f;
     constexpr float keyboardY = 60.f;
@@ -152,49 +188,40 @@ void pe::intern::UIManager::createVirtualKeyboard() {
 
     const auto& spaceBar = new_s_p(Button, ("virtkey:space", 50, keyboardY + rowPadding * 4.f + 2.5f, 10, 3, "space", this, true));
     spaceBar->setGamepadSelectionId(4 * rowWidth);
-
-    const auto& menuLower = UI::addMenu("virtKeyboard_lower");
-    menuLower->addComponent(spaceBar);
-    const auto& menuUpper = UI::addMenu("virtKeyboard_upper");
-    menuUpper->addComponent(spaceBar);
+    keyboard.addComponent(spaceBar);
 
     const float panelPadding = 1.f;
     const auto& panel = new_s_p(Panel, ("virtKeyboardPanel", 
         keyboardX - panelPadding, keyboardY - panelPadding, (keyWidth + keyPadding) * rowWidth + panelPadding * 1.5f, rowPadding * 5.f + panelPadding * 2, "", true, false
     ));
 
-    auto initKeyboard = [&](s_p<Menu> keyboard, const std::vector<std::string> rows) {
-        std::vector<std::vector<int>> grid;
-        for (int row = 0; row < rows.size(); row++) {
-            grid.push_back({});
+    std::vector<std::vector<int>> grid;
+    for (int row = 0; row < rows.size(); row++) {
+        grid.push_back({});
 
-            const float x = rowCoords.at(row).x;
-            const float y = rowCoords.at(row).y;
-            for (int i = 0; i < rows.at(row).length(); i++) {
-                const std::string rowString = rows.at(row);
-                std::string character(1, rowString.at(i));
+        const float x = rowCoords.at(row).x;
+        const float y = rowCoords.at(row).y;
+        for (int i = 0; i < rows.at(row).length(); i++) {
+            const std::string rowString = rows.at(row);
+            std::string character(1, rowString.at(i));
 
-                if (character == "\b") character = "back";
-                else if (character == "") character = "done";
-                else if (character == "§") character = "caps";
+            if (character == "\b") character = "back";
+            else if (character == "") character = "done";
+            else if (character == "§") character = "caps";
 
-                const auto& keyButton = new_s_p(Button, ("virtkey:" + character, x + (keyWidth + keyPadding) * i, y, keyWidth, keyHeight, character, this, false));
-                keyButton->setGamepadSelectionId(i + row * rowWidth);
-                grid.at(row).push_back(keyButton->getGamepadSelectionId());
+            const auto& keyButton = new_s_p(Button, ("virtkey:" + character, x + (keyWidth + keyPadding) * i, y, keyWidth, keyHeight, character, this, false));
+            keyButton->setGamepadSelectionId(i + row * rowWidth);
+            grid.at(row).push_back(keyButton->getGamepadSelectionId());
 
-                keyboard->addComponent(keyButton);
-                panel->attach(keyButton);
-            }
+            keyboard.addComponent(keyButton);
+            panel->attach(keyButton);
         }
-        grid.push_back({ {spaceBar->getGamepadSelectionId()} });
-
-        keyboard->defineGamepadSelectionGrid(grid);
-        keyboard->addComponent(panel);
-    };
+    }
+    grid.push_back({ {spaceBar->getGamepadSelectionId()} });
 
-    initKeyboard(menuLower, lowerRows);
-    initKeyboard(menuUpper, upperRows);
-    panel->attach("virtkey:space");
+    keyboard.defineGamepadSelectionGrid(grid);
+    keyboard.addComponent(panel);
+    panel->attach(spaceBar);
 }
 
 void pe::intern::UIManager::buttonPressed(std::string id) {
@@ -5,6 +5,7 @@
 #define _UI_MANAGER_H
 
 #include <SFML/Graphics/Texture.hpp>
+#include <unordered_map>
 #include "../input/Gamepad/GamepadListener.h"
 #include "../input/KeyListener.h"
 #include "../input/MouseListener.h"
@@ -13,6 +14,8 @@
 #include "../core/Defines.h"
 
 namespace pe {
+    constexpr const char* UI_SPRITE_SHEET_PATH = "res/ui_sprite_sheet.png";
+
     namespace intern {
         class UIManager : public KeyListener, public MouseListener, public GamepadListener, public ButtonListener {
         public:
@@ -24,7 +27,9 @@ namespace pe {
             void setSurface(sf::RenderTexture* surface);
             sf::RenderTexture* getSurface();
 
-            std::vector<s_p<Menu>>& getMenus();
+            s_p<Menu> addMenu(const std::string& id);
+            s_p<Menu> getMenu(const std::string& id) const;
+            const std::vector<s_p<Menu>>& getMenus() const;
 
             s_p<sf::Texture> getSpriteSheet() const;
 
@@ -49,9 +54,15 @@ namespace pe {
 
             virtual void buttonPressed(std::string id);
         private:
+            void buildVirtualKeyboard(Menu& keyboard, bool upperCase);
+
+            // Whether an open menu has something at this point of the UI surface
+            bool isOverMenu(float x, float y) const;
+
             sf::RenderTexture* _surface = nullptr;
 
             std::vector<s_p<Menu>> _menus;
+            std::unordered_map<std::string, s_p<Menu>> _menuLookup;
 
             s_p<sf::Texture> _spriteSheet = new_s_p(sf::Texture, ());
         };
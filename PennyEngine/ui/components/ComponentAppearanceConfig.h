@@ -41,6 +41,17 @@ namespace pe {
         // How big a pixel of the texture should appear on-screen
         float pixelSize;
 
+        bool operator==(const ComponentAppearanceConfig& other) const {
+            return pixelSize == other.pixelSize
+                && topLeftCorner == other.topLeftCorner && leftEdge == other.leftEdge && bottomLeftCorner == other.bottomLeftCorner
+                && centerTop == other.centerTop && center == other.center && centerBottom == other.centerBottom
+                && topRightCorner == other.topRightCorner && rightEdge == other.rightEdge && bottomRightCorner == other.bottomRightCorner;
+        }
+
+        bool operator!=(const ComponentAppearanceConfig& other) const {
+            return !(*this == other);
+        }
+
         ComponentAppearanceConfig offsetBy(int x, int y) {
             return {
                 pixelSize,
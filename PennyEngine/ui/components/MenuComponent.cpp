@@ -15,17 +15,9 @@ pe::MenuComponent::MenuComponent(const std::string id, float x, float y, float w
 
     _appearance = appearance;
 
-    const auto& spriteSheet = UI::getSpriteSheet().get();
-    _leftEdge.setTexture(spriteSheet);
-    _leftTopCorner.setTexture(spriteSheet);
-    _leftBottomCorner.setTexture(spriteSheet);
-    _center.setTexture(spriteSheet);
-    _centerTop.setTexture(spriteSheet);
-    _centerBottom.setTexture(spriteSheet);
-    _rightEdge.setTexture(spriteSheet);
-    _rightTopCorner.setTexture(spriteSheet);
-    _rightBottomCorner.setTexture(spriteSheet); 
-    
+    _geometry.setPrimitiveType(sf::Quads);
+    _geometry.resize(9 * 4);
+
     if (autoCenter) {
         constructShapes();
         _pos.x -= getBounds().width / 2.f;
@@ -43,88 +35,66 @@ void pe::MenuComponent::render(sf::RenderTexture& surface, const sf::RenderState
     draw(surface);
 }
 
-void pe::MenuComponent::constructShapes() {
-    const float padding = 0;//UI::percentToScreenWidth(1.5f);
+static void setQuad(sf::Vertex* quad, float left, float top, float width, float height, sf::IntRect textureRect) {
+    quad[0].position = { left, top };
+    quad[1].position = { left + width, top };
+    quad[2].position = { left + width, top + height };
+    quad[3].position = { left, top + height };
 
-    const float x = _pos.x - padding;
-    const float y = _pos.y;
-    const float width = _size.x + padding * 2;
-    const float height = _size.y;
+    const float texLeft = (float)textureRect.left;
+    const float texTop = (float)textureRect.top;
+    const float texRight = (float)(textureRect.left + textureRect.width);
+    const float texBottom = (float)(textureRect.top + textureRect.height);
+    quad[0].texCoords = { texLeft, texTop };
+    quad[1].texCoords = { texRight, texTop };
+    quad[2].texCoords = { texRight, texBottom };
+    quad[3].texCoords = { texLeft, texBottom };
+}
 
+void pe::MenuComponent::constructShapes() {
     const float pixelSize = UI::percentToScreenWidth(_appearance.pixelSize);
+    if (!_geometryDirty && _pos == _geometryPos && _size == _geometrySize && pixelSize == _geometryPixelSize) return;
 
-    _leftEdge.setSize({ pixelSize * _appearance.leftEdge.width, height });
-    _leftEdge.setPosition(x, y);
-    _leftEdge.setTextureRect({ _appearance.leftEdge.left, _appearance.leftEdge.top, _appearance.leftEdge.width, _appearance.leftEdge.height });
-
-    _leftTopCorner.setSize({ pixelSize * _appearance.topLeftCorner.width, pixelSize * _appearance.topLeftCorner.height });
-    _leftTopCorner.setPosition(x, y - pixelSize * _appearance.topLeftCorner.height);
-    _leftTopCorner.setTextureRect({ _appearance.topLeftCorner.left, _appearance.topLeftCorner.top, _appearance.topLeftCorner.width, _appearance.topLeftCorner.height });
-
-    _leftBottomCorner.setSize({ pixelSize * _appearance.bottomLeftCorner.width, pixelSize * _appearance.bottomLeftCorner.height });
-    _leftBottomCorner.setPosition(x, y + _leftEdge.getGlobalBounds().height);
-    _leftBottomCorner.setTextureRect({ _appearance.bottomLeftCorner.left, _appearance.bottomLeftCorner.top, _appearance.bottomLeftCorner.width, _appearance.bottomLeftCorner.height });
-
-    _center.setSize({ width - _leftEdge.getGlobalBounds().width, height });
-    _center.setPosition(x + _leftEdge.getGlobalBounds().width, y);
-    _center.setTextureRect({ _appearance.center.left, _appearance.center.top, _appearance.center.width, _appearance.center.height });
-
-    _centerTop.setSize({ width - _leftTopCorner.getGlobalBounds().width, pixelSize * _appearance.centerTop.height });
-    _centerTop.setPosition(_leftTopCorner.getGlobalBounds().width + _leftTopCorner.getPosition().x, y - pixelSize * _appearance.centerTop.height);
-    _centerTop.setTextureRect({ _appearance.centerTop.left, _appearance.centerTop.top, _appearance.centerTop.width, _appearance.centerTop.height });
-
-    _centerBottom.setSize({ width - _leftEdge.getGlobalBounds().width, pixelSize * _appearance.centerBottom.height });
-    _centerBottom.setPosition(x + _leftEdge.getGlobalBounds().width, y + _center.getGlobalBounds().height);
-    _centerBottom.setTextureRect({ _appearance.centerBottom.left, _appearance.centerBottom.top, _appearance.centerBottom.width, _appearance.centerBottom.height });
-
-    _rightEdge.setSize({ pixelSize * _appearance.rightEdge.width, height });
-    _rightEdge.setPosition(x + _leftEdge.getGlobalBounds().width + _center.getGlobalBounds().width, y);
-    _rightEdge.setTextureRect({ _appearance.rightEdge.left, _appearance.rightEdge.top, _appearance.rightEdge.width, _appearance.rightEdge.height });
-
-    _rightTopCorner.setSize({ pixelSize * _appearance.topRightCorner.width, pixelSize * _appearance.topRightCorner.height });
-    _rightTopCorner.setPosition(x + _leftEdge.getGlobalBounds().width + _center.getGlobalBounds().width, y - pixelSize * _appearance.topRightCorner.height);
-    _rightTopCorner.setTextureRect({ _appearance.topRightCorner.left, _appearance.topRightCorner.top, _appearance.topRightCorner.width, _appearance.topRightCorner.height });
-
-    _rightBottomCorner.setSize({ pixelSize * _appearance.bottomRightCorner.width, pixelSize * _appearance.bottomRightCorner.height });
-    _rightBottomCorner.setPosition(x + _leftEdge.getGlobalBounds().width + _center.getGlobalBounds().width, y + _rightEdge.getGlobalBounds().height);
-    _rightBottomCorner.setTextureRect({ _appearance.bottomRightCorner.left, _appearance.bottomRightCorner.top, _appearance.bottomRightCorner.width, _appearance.bottomRightCorner.height });
-
-    constexpr int maxAttempts = 10;
-    int timesLeft = 1;
-    while (!_leftEdge.getGlobalBounds().intersects(_center.getGlobalBounds())) {
-        constexpr float gapCorrectionStep = 0.1f;
-        _leftTopCorner.move(gapCorrectionStep, 0);
-        _leftEdge.move(gapCorrectionStep, 0);
-        _leftBottomCorner.move(gapCorrectionStep, 0);
-        timesLeft++;
-        if (timesLeft > maxAttempts) break;
-    }
+    const float x = _pos.x;
+    const float y = _pos.y;
+    const float width = _size.x;
+    const float height = _size.y;
 
-    int timesRight = 1;
-    while (!_rightEdge.getGlobalBounds().intersects(_center.getGlobalBounds())) {
-        constexpr float gapCorrectionStep = -0.1f;
-        _rightTopCorner.move(gapCorrectionStep, 0);
-        _rightEdge.move(gapCorrectionStep, 0);
-        _rightBottomCorner.move(gapCorrectionStep, 0);
-        timesRight++;
-        if (timesRight > maxAttempts) break;
-    } 
-
-    if (timesLeft > 5 || timesRight > 5) {
-        Logger::log("Cap correction took longer than five attempts\ntimesLeft was: " + std::to_string(timesLeft) + "\ntimesRight was: " + std::to_string(timesRight));
-    }
+    // The slices share their edge coordinates exactly, so there are no seams between them
+    const float leftWidth = pixelSize * _appearance.leftEdge.width;
+    const float centerWidth = width - leftWidth;
+    const float rightX = x + leftWidth + centerWidth;
+    const float topLeftWidth = pixelSize * _appearance.topLeftCorner.width;
+
+    sf::Vertex* quad = &_geometry[0];
+    setQuad(quad, x, y, leftWidth, height, _appearance.leftEdge);
+    setQuad(quad += 4, x, y - pixelSize * _appearance.topLeftCorner.height, 
+        topLeftWidth, pixelSize * _appearance.topLeftCorner.height, _appearance.topLeftCorner);
+    setQuad(quad += 4, x, y + height, 
+        pixelSize * _appearance.bottomLeftCorner.width, pixelSize * _appearance.bottomLeftCorner.height, _appearance.bottomLeftCorner);
+
+    setQuad(quad += 4, x + leftWidth, y, centerWidth, height, _appearance.center);
+    setQuad(quad += 4, x + topLeftWidth, y - pixelSize * _appearance.centerTop.height, 
+        width - topLeftWidth, pixelSize * _appearance.centerTop.height, _appearance.centerTop);
+    setQuad(quad += 4, x + leftWidth, y + height, 
+        centerWidth, pixelSize * _appearance.centerBottom.height, _appearance.centerBottom);
+
+    setQuad(quad += 4, rightX, y, pixelSize * _appearance.rightEdge.width, height, _appearance.rightEdge);
+    setQuad(quad += 4, rightX, y - pixelSize * _appearance.topRightCorner.height, 
+        pixelSize * _appearance.topRightCorner.width, pixelSize * _appearance.topRightCorner.height, _appearance.topRightCorner);
+    setQuad(quad += 4, rightX, y + height, 
+        pixelSize * _appearance.bottomRightCorner.width, pixelSize * _appearance.bottomRightCorner.height, _appearance.bottomRightCorner);
+
+    _geometryPos = _pos;
+    _geometrySize = _size;
+    _geometryPixelSize = pixelSize;
+    _geometryDirty = false;
 }
 
 void pe::MenuComponent::drawShapes(sf::RenderTexture& surface, const sf::RenderStates& states) {
-    surface.draw(_leftEdge);
-    surface.draw(_leftTopCorner);
-    surface.draw(_leftBottomCorner);
-    surface.draw(_center);
-    surface.draw(_centerTop);
-    surface.draw(_centerBottom);
-    surface.draw(_rightEdge);
-    surface.draw(_rightTopCorner);
-    surface.draw(_rightBottomCorner);
+    sf::RenderStates geometryStates = states;
+    geometryStates.texture = UI::getSpriteSheet().get();
+    surface.draw(_geometry, geometryStates);
 }
 
 void pe::MenuComponent::alignText() {
@@ -190,7 +160,9 @@ std::string pe::MenuComponent::getIdentifier() const {
 }
 
 void pe::MenuComponent::setAppearance(ComponentAppearanceConfig appearance) {
+    if (appearance == _appearance) return;
     _appearance = appearance;
+    _geometryDirty = true;
 }
 
 void pe::MenuComponent::move(float x, float y) {
@@ -251,7 +223,9 @@ void pe::MenuComponent::textEntered(const sf::Uint32 character) {
 }
 
 sf::FloatRect pe::MenuComponent::getBounds() const {
-    const float width = _leftEdge.getSize().x + _center.getSize().x + _rightEdge.getSize().x;
-    const float height = _centerTop.getSize().y + _center.getSize().y + _centerBottom.getSize().y;
-    return {_pos.x, _pos.y - _centerTop.getSize().y, width, height};
+    const float pixelSize = UI::percentToScreenWidth(_appearance.pixelSize);
+    const float topHeight = pixelSize * _appearance.centerTop.height;
+    const float width = _size.x + pixelSize * _appearance.rightEdge.width;
+    const float height = topHeight + _size.y + pixelSize * _appearance.centerBottom.height;
+    return {_pos.x, _pos.y - topHeight, width, height};
 }
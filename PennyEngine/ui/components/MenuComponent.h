@@ -10,6 +10,7 @@
 #include <SFML/Window/Keyboard.hpp>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include "ComponentAppearanceConfig.h"
 #include "AppearanceConfigs.h"
@@ -93,19 +94,16 @@ namespace pe {
 
         ComponentAppearanceConfig _appearance;
 
-        sf::RectangleShape _leftEdge;
-        sf::RectangleShape _leftTopCorner;
-        sf::RectangleShape _leftBottomCorner;
-        sf::RectangleShape _center;
-        sf::RectangleShape _centerTop;
-        sf::RectangleShape _centerBottom;
-        sf::RectangleShape _rightEdge;
-        sf::RectangleShape _rightTopCorner;
-        sf::RectangleShape _rightBottomCorner;
+        // All nine slices of the component's frame as quads, drawn in one call.
+        // Only rebuilt when the position, size or appearance has changed
+        sf::VertexArray _geometry;
     private:
+        bool _geometryDirty = true;
+        sf::Vector2f _geometryPos;
+        sf::Vector2f _geometrySize;
+        float _geometryPixelSize = 0.f;
+
         const std::string _id;
-        
-        std::map<std::string, unsigned int> _zPositions;
     };
 }
 
@@ -18,6 +18,9 @@ pe::TextField::TextField(std::string id, float x, float y, float width, float he
     _fieldText.setFillColor(sf::Color::White);
     _fieldText.setString(defaultText);
 
+    _cursor.setFont(PennyEngine::getFont());
+    _cursor.setString(" |");
+
     _minWidth = UI::percentToScreenWidth(width);
     _minHeight = UI::percentToScreenHeight(height);
 
@@ -64,17 +67,11 @@ void pe::TextField::draw(sf::RenderTexture& surface) {
     surface.draw(_fieldText);
 
     if (_isArmed) {
-        sf::Text cursor;
-        cursor.setString(" |");
-        cursor.setFont(PennyEngine::getFont());
-        cursor.setCharacterSize(_fieldText.getCharacterSize() + UI::percentToScreenWidth(0.5f));
-        cursor.setFillColor(_fieldText.getFillColor());
-        cursor.setOrigin(cursor.getLocalBounds().width / 2.f + cursor.getLocalBounds().left, cursor.getLocalBounds().height / 2.f + cursor.getLocalBounds().top);
-        cursor.setPosition(_fieldText.getPosition().x + _fieldText.getGlobalBounds().width / 2.f, _fieldText.getPosition().y);
-        constexpr unsigned int blinkRate = 24;
-        if ((_cursorBlinkTimer / blinkRate) % 2) surface.draw(cursor);
-
-        _cursorBlinkTimer++;
+        _cursor.setCharacterSize(_fieldText.getCharacterSize() + UI::percentToScreenWidth(0.5f));
+        _cursor.setFillColor(_fieldText.getFillColor());
+        _cursor.setOrigin(_cursor.getLocalBounds().width / 2.f + _cursor.getLocalBounds().left, _cursor.getLocalBounds().height / 2.f + _cursor.getLocalBounds().top);
+        _cursor.setPosition(_fieldText.getPosition().x + _fieldText.getGlobalBounds().width / 2.f, _fieldText.getPosition().y);
+        if ((int)(PennyEngine::getElapsedTime().asSeconds() / CURSOR_BLINK_SECONDS) % 2) surface.draw(_cursor);
     }
 }
 
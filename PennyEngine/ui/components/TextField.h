@@ -9,6 +9,8 @@
 class VisualNode;
 
 namespace pe {
+    constexpr float CURSOR_BLINK_SECONDS = 0.4f;
+
     class TextField : public MenuComponent {
     public:
         TextField(std::string id, float x, float y, float width, float height, std::string label, std::string defaultText = "", 
@@ -36,6 +38,8 @@ namespace pe {
     private:
         sf::Text _fieldText;
         sf::Vector2f _fieldTextPos;
+
+        sf::Text _cursor;
         
         sf::Vector2i _mPos;
         bool _mouseDown = false;
@@ -54,8 +58,6 @@ namespace pe {
 
         void gamepadArm();
         void gamepadDisarm();
-
-        unsigned int _cursorBlinkTimer = 0;
     };
 }
 
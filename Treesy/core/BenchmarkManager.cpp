@@ -0,0 +1,541 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "BenchmarkManager.h"
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <queue>
+#include <unordered_map>
+#include "../../PennyEngine/PennyEngine.h"
+#include "../../PennyEngine/core/Logger.h"
+#include "../visual/VisualTree.h"
+#include "Persistence.h"
+#include "BracketNotation.h"
+#include "LabelIndex.h"
+#include "TreeDiff.h"
+#include "PngEncoder.h"
+#include "Settings.h"
+#include "Versioning.h"
+
+constexpr unsigned int BENCHMARK_SEED = 0x7EE5;
+constexpr unsigned int BENCHMARK_MIN_NODES = 100;
+// Deep chains are split into several spines so alignNode's recursion stays within the stack
+constexpr unsigned int BENCHMARK_MAX_CHAIN_DEPTH = 1000;
+// Small trees are repeated into a corpus of at least this size so parsing is timed on realistic file sizes
+constexpr size_t BENCHMARK_CORPUS_BYTES = 4 * 1024 * 1024;
+
+struct SyntheticNode {
+    int parent;
+    std::vector<int> children;
+    std::string label;
+};
+
+typedef std::vector<SyntheticNode> SyntheticTree;
+
+static int addSyntheticNode(SyntheticTree& tree, int parent, std::string label) {
+    tree.push_back({ parent, {}, label });
+    const int index = (int)tree.size() - 1;
+    if (parent != -1) tree.at(parent).children.push_back(index);
+    return index;
+}
+
+static SyntheticTree generateBalanced(unsigned int nodeCount) {
+    SyntheticTree tree;
+    tree.reserve(nodeCount);
+    addSyntheticNode(tree, -1, "XP");
+    for (unsigned int i = 1; i < nodeCount; i++) {
+        addSyntheticNode(tree, (i - 1) / 2, i % 2 ? "X" : "YP");
+    }
+    return tree;
+}
+
+static SyntheticTree generateDeep(unsigned int nodeCount) {
+    SyntheticTree tree;
+    tree.reserve(nodeCount);
+    addSyntheticNode(tree, -1, "CP");
+
+    // Right-branching spines with a specifier hanging off of every spine node
+    int spine = 0;
+    unsigned int depth = 0;
+    while (tree.size() < nodeCount) {
+        if (depth >= BENCHMARK_MAX_CHAIN_DEPTH) {
+            spine = 0;
+            depth = 0;
+        }
+
+        addSyntheticNode(tree, spine, "Spec");
+        if (tree.size() >= nodeCount) break;
+        spine = addSyntheticNode(tree, spine, "XP");
+        depth++;
+    }
+    return tree;
+}
+
+static SyntheticTree generateWide(unsigned int nodeCount) {
+    SyntheticTree tree;
+    tree.reserve(nodeCount);
+    addSyntheticNode(tree, -1, "ConjP");
+    for (unsigned int i = 1; i < nodeCount; i++) {
+        addSyntheticNode(tree, 0, "w" + std::to_string(i));
+    }
+    return tree;
+}
+
+static SyntheticTree generateTreebank(unsigned int nodeCount) {
+    static const std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> grammar = {
+        { "S", { { "NP", "VP" }, { "S", "Conj", "S" }, { "NP", "VP", "PP" } } },
+        { "NP", { { "D", "N" }, { "D", "Adj", "N" }, { "N" }, { "NP", "PP" } } },
+        { "VP", { { "V", "NP" }, { "V" }, { "VP", "PP" }, { "V", "S" } } },
+        { "PP", { { "P", "NP" } } },
+    };
+    static const std::vector<std::pair<std::string, std::vector<std::string>>> lexicon = {
+        { "D", { "the", "a", "every", "some" } },
+        { "N", { "cat", "dog", "linguist", "mat", "tree", "sentence" } },
+        { "Adj", { "big", "old", "syntactic", "green" } },
+        { "V", { "saw", "sat", "parsed", "believed", "drew" } },
+        { "P", { "on", "with", "under", "near" } },
+        { "Conj", { "and", "but", "or" } },
+    };
+
+    std::mt19937 rng(BENCHMARK_SEED);
+
+    SyntheticTree tree;
+    tree.reserve(nodeCount);
+    addSyntheticNode(tree, -1, "S");
+
+    // Expanding breadth-first keeps the depth logarithmic even for 100k node trees
+    std::queue<int> frontier;
+    frontier.push(0);
+    while (!frontier.empty() && tree.size() < nodeCount) {
+        const int index = frontier.front();
+        frontier.pop();
+        const std::string label = tree.at(index).label;
+
+        bool expanded = false;
+        for (const auto& rule : grammar) {
+            if (rule.first != label) continue;
+            const auto& expansion = rule.second.at(rng() % rule.second.size());
+            for (const auto& childLabel : expansion) {
+                if (tree.size() >= nodeCount) break;
+                frontier.push(addSyntheticNode(tree, index, childLabel));
+            }
+            expanded = true;
+            break;
+        }
+
+        if (expanded) continue;
+
+        for (const auto& entry : lexicon) {
+            if (entry.first != label) continue;
+            addSyntheticNode(tree, index, entry.second.at(rng() % entry.second.size()));
+            break;
+        }
+    }
+
+    // Recursive rules can die out early on small budgets, so pad with more clauses
+    while (tree.size() < nodeCount) {
+        const int clause = addSyntheticNode(tree, 0, "S");
+        if (tree.size() < nodeCount) addSyntheticNode(tree, clause, "it");
+    }
+    return tree;
+}
+
+static SyntheticTree generateTree(const std::string& shape, unsigned int nodeCount) {
+    if (shape == "balanced") return generateBalanced(nodeCount);
+    else if (shape == "deep") return generateDeep(nodeCount);
+    else if (shape == "wide") return generateWide(nodeCount);
+    return generateTreebank(nodeCount);
+}
+
+static TreeSnapshot toSnapshot(const SyntheticTree& tree) {
+    TreeSnapshot snapshot;
+    snapshot.nodes.reserve(tree.size());
+
+    // Synthetic trees are generated breadth-first, but snapshots have to be in preorder
+    std::unordered_map<std::string, s_p<const sf::String>> labels;
+    std::vector<std::pair<int, int>> stack = { { 0, -1 } };
+    while (!stack.empty()) {
+        const auto [index, parent] = stack.back();
+        stack.pop_back();
+
+        const auto& node = tree.at(index);
+        auto& label = labels[node.label];
+        if (label == nullptr) label = std::make_shared<const sf::String>(node.label);
+
+        const int snapshotIndex = snapshot.addNode(parent, label);
+        for (auto it = node.children.rbegin(); it != node.children.rend(); it++) {
+            stack.push_back({ *it, snapshotIndex });
+        }
+    }
+    return snapshot;
+}
+
+static void writeSyntheticTree(const SyntheticTree& tree, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    out << "VERSION:" << VERSION << "\n";
+
+    std::vector<sf::Vector2f> positions(tree.size());
+    for (size_t i = 0; i < tree.size(); i++) {
+        const auto& node = tree.at(i);
+        positions.at(i) = node.parent == -1 ? sf::Vector2f(50.f, 10.f)
+            : sf::Vector2f(positions.at(node.parent).x, positions.at(node.parent).y + Settings::nontermVerticalDistance);
+
+        out << "{\n";
+        out << "id: n" << i << "\n";
+        out << "pos: " << std::to_string(positions.at(i).x) << ", " << std::to_string(positions.at(i).y) << "\n";
+        if (node.parent != -1) out << "parent: n" << node.parent << "\n";
+        if (!node.children.empty()) {
+            out << "children: ";
+            for (size_t c = 0; c < node.children.size(); c++) {
+                out << "n" << node.children.at(c) << (c < node.children.size() - 1 ? ", " : "");
+            }
+            out << "\n";
+        }
+        out << "text: \"" << node.label << "\"\n";
+        out << "subs: \"\"\n";
+        out << "hasMovement: false\n";
+        out << "curveAngle: 0.000000\n";
+        out << "curveHeight: 0.000000\n";
+        out << "triangle: false\n";
+        out << "}\n";
+    }
+
+    out.close();
+}
+
+static double elapsedMillis(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static unsigned int iterationsFor(unsigned int nodeCount, unsigned int budget, unsigned int minIterations, unsigned int maxIterations) {
+    return std::max(minIterations, std::min(maxIterations, budget / nodeCount));
+}
+
+BenchmarkManager::BenchmarkManager(unsigned int maxNodes) {
+    _maxNodes = std::max(maxNodes, BENCHMARK_MIN_NODES);
+}
+
+void BenchmarkManager::init() {
+}
+
+void BenchmarkManager::update() {
+    // Waits for the first frame so startup can be timed too
+    if (_finished || PennyEngine::getTimeToFirstFrame() == 0) return;
+    _finished = true;
+
+    run();
+    PennyEngine::stop();
+}
+
+void BenchmarkManager::draw(sf::RenderTexture& surface) {
+}
+
+void BenchmarkManager::drawUI(sf::RenderTexture& surface) {
+}
+
+void BenchmarkManager::onShutdown() {
+}
+
+void BenchmarkManager::run() {
+    const std::vector<std::string> shapes = { "balanced", "deep", "wide", "treebank" };
+
+    for (const auto& timing : PennyEngine::getStartupTimings()) {
+        record("startup", 0, timing.phase, timing.millis, "ms");
+    }
+
+    for (unsigned int nodeCount = BENCHMARK_MIN_NODES; nodeCount <= _maxNodes; nodeCount *= 10) {
+        for (const auto& shape : shapes) {
+            runShape(shape, nodeCount);
+        }
+    }
+
+    writeResults(PennyEngine::getAppName() + "_bench.json");
+}
+
+void BenchmarkManager::runShape(const std::string& shape, unsigned int nodeCount) {
+    pe::Logger::log("Benchmarking " + shape + " tree with " + std::to_string(nodeCount) + " nodes");
+
+    const std::string path = PennyEngine::getAppName() + "_bench_" + shape + "_" + std::to_string(nodeCount) + ".treesy";
+    const SyntheticTree tree = generateTree(shape, nodeCount);
+    writeSyntheticTree(tree, path);
+
+    benchmarkPersistence(shape, nodeCount, path);
+    benchmarkLayout(shape, nodeCount);
+    benchmarkHitTest(shape, nodeCount);
+    benchmarkInputDispatch(shape, nodeCount);
+    benchmarkFrame(shape, nodeCount);
+    benchmarkExport(shape, nodeCount);
+    benchmarkBrackets(shape, nodeCount);
+    benchmarkSearch(shape, nodeCount);
+    benchmarkDiff(shape, nodeCount, toSnapshot(tree));
+    // Replaces the tree, so it runs last
+    benchmarkBuild(shape, nodeCount, toSnapshot(tree));
+
+    VisualTree::reset();
+    std::filesystem::remove(path);
+}
+
+void BenchmarkManager::benchmarkPersistence(const std::string& shape, unsigned int nodeCount, const std::string& path) {
+    VisualTree::reset();
+    auto start = std::chrono::steady_clock::now();
+    Persistence::load(path);
+    const double loadTime = elapsedMillis(start);
+
+    record(shape, nodeCount, "load", loadTime, "ms");
+    record(shape, nodeCount, "loadThroughput", nodeCount / (loadTime / 1000.0), "nodes/s");
+
+    const std::string savePath = path + ".out";
+    start = std::chrono::steady_clock::now();
+    Persistence::save(savePath);
+    const double saveTime = elapsedMillis(start);
+
+    const double megabytes = (double)std::filesystem::file_size(savePath) / (1024.0 * 1024.0);
+    record(shape, nodeCount, "save", saveTime, "ms");
+    record(shape, nodeCount, "saveThroughput", nodeCount / (saveTime / 1000.0), "nodes/s");
+    record(shape, nodeCount, "saveBandwidth", megabytes / (saveTime / 1000.0), "MB/s");
+
+    std::filesystem::remove(savePath);
+}
+
+void BenchmarkManager::benchmarkLayout(const std::string& shape, unsigned int nodeCount) {
+    auto& tree = VisualTree::_instance;
+    if (tree._nodes.empty()) return;
+    const auto root = tree._nodes.at(0);
+
+    const unsigned int iterations = iterationsFor(nodeCount, 200000, 3, 100);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        tree.alignNode(root);
+        PennyEngine::getFrameArena().reset();
+    }
+    record(shape, nodeCount, "alignNode", elapsedMillis(start) / iterations, "ms");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        tree.centerNodes(root);
+    }
+    record(shape, nodeCount, "centerNodes", elapsedMillis(start) / iterations, "ms");
+}
+
+void BenchmarkManager::benchmarkHitTest(const std::string& shape, unsigned int nodeCount) {
+    const auto& nodes = VisualTree::_instance._nodes;
+    if (nodes.empty()) return;
+
+    sf::FloatRect extent = nodes.at(0)->getBounds();
+    for (const auto& node : nodes) {
+        const sf::FloatRect bounds = node->getBounds();
+        const float right = std::max(extent.left + extent.width, bounds.left + bounds.width);
+        const float bottom = std::max(extent.top + extent.height, bounds.top + bounds.height);
+        extent.left = std::min(extent.left, bounds.left);
+        extent.top = std::min(extent.top, bounds.top);
+        extent.width = right - extent.left;
+        extent.height = bottom - extent.top;
+    }
+
+    std::mt19937 rng(BENCHMARK_SEED);
+    std::uniform_real_distribution<float> xDist(extent.left, extent.left + extent.width);
+    std::uniform_real_distribution<float> yDist(extent.top, extent.top + extent.height);
+
+    const unsigned int queries = iterationsFor(nodeCount, 10000000, 10, 1000);
+    unsigned int hits = 0;
+
+    // A linear scan for the first active node under each point, as a baseline for per-node hit-testing cost.
+    // Click routing itself is timed by benchmarkInputDispatch
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < queries; i++) {
+        const sf::Vector2f point(xDist(rng), yDist(rng));
+        for (const auto& node : nodes) {
+            if (node->isActive() && node->getBounds().contains(point)) {
+                hits++;
+                break;
+            }
+        }
+    }
+    record(shape, nodeCount, "hitTest", elapsedMillis(start) * 1000.0 / queries, "us");
+    record(shape, nodeCount, "hitRate", (double)hits / queries, "ratio");
+}
+
+void BenchmarkManager::benchmarkInputDispatch(const std::string& shape, unsigned int nodeCount) {
+    std::mt19937 rng(BENCHMARK_SEED);
+    const auto& res = PennyEngine::getRenderResolution();
+    std::uniform_int_distribution<int> xDist(0, res.width);
+    std::uniform_int_distribution<int> yDist(0, res.height);
+
+    const unsigned int events = iterationsFor(nodeCount, 100000, 3, 100);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < events; i++) {
+        VisualTree::_instance.mouseMoved(xDist(rng), yDist(rng));
+    }
+    record(shape, nodeCount, "mouseMoveDispatch", elapsedMillis(start) / events, "ms");
+}
+
+void BenchmarkManager::benchmarkFrame(const std::string& shape, unsigned int nodeCount) {
+    const auto& res = PennyEngine::getRenderResolution();
+    sf::RenderTexture surface;
+    if (!surface.create(res.width, res.height)) {
+        pe::Logger::log("Could not create benchmark surface");
+        return;
+    }
+
+    sf::View view = PennyEngine::getCamera();
+    surface.setView(view);
+
+    // Let the nodes settle into their resting positions before timing anything
+    VisualTree::update();
+
+    const unsigned int frames = iterationsFor(nodeCount, 20000, 3, 60);
+    double slowest = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < frames; i++) {
+        const auto frameStart = std::chrono::steady_clock::now();
+        VisualTree::update();
+        surface.clear(Settings::bgColor);
+        VisualTree::draw(surface);
+        surface.display();
+        PennyEngine::getFrameArena().reset();
+        slowest = std::max(slowest, elapsedMillis(frameStart));
+    }
+    record(shape, nodeCount, "frame", elapsedMillis(start) / frames, "ms");
+    record(shape, nodeCount, "frameMax", slowest, "ms");
+}
+
+void BenchmarkManager::benchmarkExport(const std::string& shape, unsigned int nodeCount) {
+    const auto& res = PennyEngine::getRenderResolution();
+    sf::RenderTexture surface;
+    if (!surface.create(res.width, res.height)) {
+        pe::Logger::log("Could not create benchmark surface");
+        return;
+    }
+
+    surface.setView(PennyEngine::getCamera());
+    surface.clear(Settings::bgColor);
+    VisualTree::draw(surface);
+    surface.display();
+    PennyEngine::getFrameArena().reset();
+    const sf::Image image = surface.getTexture().copyToImage();
+
+    const std::string path = PennyEngine::getAppName() + "_bench_export.png";
+
+    // SFML's own encoder, for comparison
+    auto start = std::chrono::steady_clock::now();
+    image.saveToFile(path);
+    record(shape, nodeCount, "exportPngSfml", elapsedMillis(start), "ms");
+
+    start = std::chrono::steady_clock::now();
+    PngEncoder::save(image, path, PNG_COMPRESSION::NORMAL);
+    record(shape, nodeCount, "exportPng", elapsedMillis(start), "ms");
+    record(shape, nodeCount, "exportPngSize", (double)std::filesystem::file_size(path) / 1024.0, "KB");
+
+    start = std::chrono::steady_clock::now();
+    PngEncoder::save(image, path, PNG_COMPRESSION::FAST);
+    record(shape, nodeCount, "exportPngDraft", elapsedMillis(start), "ms");
+    record(shape, nodeCount, "exportPngDraftSize", (double)std::filesystem::file_size(path) / 1024.0, "KB");
+
+    std::filesystem::remove(path);
+}
+
+void BenchmarkManager::benchmarkBrackets(const std::string& shape, unsigned int nodeCount) {
+    const auto& nodes = VisualTree::getNodes();
+    if (nodes.empty()) return;
+
+    const TreeSnapshot snapshot = TreeSnapshot::capture(nodes.at(0).get());
+
+    auto start = std::chrono::steady_clock::now();
+    const std::string text = BracketNotation::write(snapshot);
+    const double writeTime = elapsedMillis(start);
+    record(shape, nodeCount, "bracketWrite", writeTime, "ms");
+    record(shape, nodeCount, "bracketWriteThroughput", nodeCount / (writeTime / 1000.0), "nodes/s");
+
+    std::string corpus;
+    corpus.reserve(std::max(BENCHMARK_CORPUS_BYTES, text.size()) + text.size() + 1);
+    size_t corpusNodes = 0;
+    while (corpus.empty() || corpus.size() < BENCHMARK_CORPUS_BYTES) {
+        corpus += text;
+        corpus += '\n';
+        corpusNodes += snapshot.nodes.size();
+    }
+
+    std::vector<TreeSnapshot> trees;
+    start = std::chrono::steady_clock::now();
+    if (!BracketNotation::readAll(corpus, trees)) pe::Logger::log("Benchmark corpus did not parse");
+    const double parseTime = elapsedMillis(start);
+
+    const double megabytes = (double)corpus.size() / (1024.0 * 1024.0);
+    record(shape, nodeCount, "bracketParse", parseTime, "ms");
+    record(shape, nodeCount, "bracketParseThroughput", corpusNodes / (parseTime / 1000.0), "nodes/s");
+    record(shape, nodeCount, "bracketParseBandwidth", megabytes / (parseTime / 1000.0), "MB/s");
+}
+
+void BenchmarkManager::benchmarkSearch(const std::string& shape, unsigned int nodeCount) {
+    auto& index = LabelIndex::_instance;
+    const unsigned int iterations = iterationsFor(nodeCount, 1000000, 3, 100);
+
+    // Searched directly so the camera and UI are left alone
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        index.search("s", false);
+    }
+    record(shape, nodeCount, "labelSearchPrefix", elapsedMillis(start) / iterations, "ms");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        index.search("^[a-z]+p$", true);
+    }
+    record(shape, nodeCount, "labelSearchRegex", elapsedMillis(start) / iterations, "ms");
+
+    index.clearResults();
+}
+
+void BenchmarkManager::benchmarkDiff(const std::string& shape, unsigned int nodeCount, const TreeSnapshot& tree) {
+    // Compared against a copy with every 20th node relabelled, like a second annotator's version of the tree
+    TreeSnapshot edited = tree;
+    const auto editedLabel = std::make_shared<const sf::String>("EDITED");
+    for (size_t i = 0; i < edited.nodes.size(); i += 20) edited.nodes.at(i).text = editedLabel;
+
+    const unsigned int iterations = iterationsFor(nodeCount, 1000000, 3, 20);
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; i++) {
+        TreeDiff::compare(tree, edited);
+    }
+    record(shape, nodeCount, "diff", elapsedMillis(start) / iterations, "ms");
+}
+
+void BenchmarkManager::benchmarkBuild(const std::string& shape, unsigned int nodeCount, const TreeSnapshot& tree) {
+    const auto start = std::chrono::steady_clock::now();
+    VisualTree::build(tree);
+    const double buildTime = elapsedMillis(start);
+    PennyEngine::getFrameArena().reset();
+
+    record(shape, nodeCount, "build", buildTime, "ms");
+    record(shape, nodeCount, "buildThroughput", nodeCount / (buildTime / 1000.0), "nodes/s");
+}
+
+void BenchmarkManager::record(const std::string& shape, unsigned int nodeCount, const std::string& metric, double value, const std::string& unit) {
+    _results.push_back({ shape, nodeCount, metric, value, unit });
+    pe::Logger::log(shape + "/" + std::to_string(nodeCount) + " " + metric + ": " + std::to_string(value) + " " + unit);
+}
+
+void BenchmarkManager::writeResults(const std::string& path) const {
+    std::ofstream out(path);
+    out << "{\n";
+    out << "  \"version\": \"" << VERSION << "\",\n";
+    out << "  \"build\": \"" << BUILD_NUMBER << "\",\n";
+    out << "  \"seed\": " << BENCHMARK_SEED << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < _results.size(); i++) {
+        const auto& result = _results.at(i);
+        out << "    { \"shape\": \"" << result.shape << "\", \"nodes\": " << result.nodes
+            << ", \"metric\": \"" << result.metric << "\", \"value\": " << std::to_string(result.value)
+            << ", \"unit\": \"" << result.unit << "\" }" << (i < _results.size() - 1 ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    out.close();
+
+    pe::Logger::log("Wrote benchmark results to " + path);
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _BENCHMARK_MANAGER_H
+#define _BENCHMARK_MANAGER_H
+
+#include <string>
+#include <vector>
+#include "../../PennyEngine/core/GameManager.h"
+#include "TreeSnapshot.h"
+
+constexpr unsigned int DEFAULT_BENCHMARK_MAX_NODES = 100000;
+
+struct BenchmarkResult {
+    std::string shape;
+    unsigned int nodes;
+    std::string metric;
+    double value;
+    std::string unit;
+};
+
+/*
+    Runs the layout/persistence/bracket notation/build/input/render/export/search/diff benchmarks instead of the
+    normal program when Treesy is started with --bench [maxNodes].
+
+    Every synthetic tree is generated from a fixed seed so the numbers
+    are comparable between builds. Results are written as JSON to
+    <app name>_bench.json in the working directory, and the program
+    quits once they're written.
+*/
+class BenchmarkManager : public pe::GameManager {
+public:
+    BenchmarkManager(unsigned int maxNodes = DEFAULT_BENCHMARK_MAX_NODES);
+
+    virtual void init();
+
+    virtual void update();
+    virtual void draw(sf::RenderTexture& surface);
+    virtual void drawUI(sf::RenderTexture& surface);
+protected:
+    virtual void onShutdown();
+private:
+    unsigned int _maxNodes;
+    bool _finished = false;
+
+    std::vector<BenchmarkResult> _results;
+
+    void run();
+    void runShape(const std::string& shape, unsigned int nodeCount);
+
+    void benchmarkPersistence(const std::string& shape, unsigned int nodeCount, const std::string& path);
+    void benchmarkLayout(const std::string& shape, unsigned int nodeCount);
+    void benchmarkHitTest(const std::string& shape, unsigned int nodeCount);
+    void benchmarkInputDispatch(const std::string& shape, unsigned int nodeCount);
+    void benchmarkFrame(const std::string& shape, unsigned int nodeCount);
+    void benchmarkExport(const std::string& shape, unsigned int nodeCount);
+    void benchmarkBrackets(const std::string& shape, unsigned int nodeCount);
+    void benchmarkSearch(const std::string& shape, unsigned int nodeCount);
+    void benchmarkDiff(const std::string& shape, unsigned int nodeCount, const TreeSnapshot& tree);
+    void benchmarkBuild(const std::string& shape, unsigned int nodeCount, const TreeSnapshot& tree);
+
+    void record(const std::string& shape, unsigned int nodeCount, const std::string& metric, double value, const std::string& unit);
+    void writeResults(const std::string& path) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,327 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "BracketNotation.h"
+#include <unordered_map>
+#include "../../PennyEngine/core/Logger.h"
+
+static bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// With keepSpaces, single spaces between words are left as they are, since the reader joins words back together
+// with one space. Any other whitespace is escaped so it survives the round trip
+static void appendEscaped(std::string& out, const sf::String& label, bool keepSpaces) {
+    const auto utf8 = label.toUtf8();
+    for (size_t i = 0; i < utf8.size(); i++) {
+        const char c = (char)utf8[i];
+        const bool separatesWords = keepSpaces && c == ' ' && i > 0 && i + 1 < utf8.size()
+            && !isWhitespace((char)utf8[i - 1]) && !isWhitespace((char)utf8[i + 1]);
+        if (c == '(' || c == ')' || c == '\\' || c == '_' || c == '^' || (isWhitespace(c) && !separatesWords)) out += '\\';
+        out += c;
+    }
+}
+
+static void appendLabel(std::string& out, const SnapshotNode& node, bool keepSpaces = false) {
+    // A lone _ stands in for an empty label, which would otherwise disappear
+    if (node.text->isEmpty() && node.subscript == nullptr) {
+        out += '_';
+        return;
+    }
+
+    appendEscaped(out, *node.text, keepSpaces);
+    if (node.subscript != nullptr) {
+        out += '_';
+        appendEscaped(out, *node.subscript, false);
+    }
+}
+
+std::string BracketNotation::write(const TreeSnapshot& tree) {
+    const auto& nodes = tree.nodes;
+
+    std::vector<int> childCounts(nodes.size(), 0);
+    for (const auto& node : nodes) {
+        if (node.parent != -1) childCounts.at(node.parent)++;
+    }
+
+    std::string out;
+    out.reserve(nodes.size() * 8);
+    std::vector<int> openBrackets;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const auto& node = nodes.at(i);
+        while (!openBrackets.empty() && openBrackets.back() != node.parent) {
+            out += ')';
+            openBrackets.pop_back();
+        }
+        if (i != 0) out += ' ';
+
+        if (childCounts.at(i) == 0) {
+            appendLabel(out, node);
+        } else if (childCounts.at(i) == 1 && nodes.at(i + 1).drawTriangle && childCounts.at(i + 1) == 0) {
+            // In preorder, a node's first child comes right after it
+            out += "(^";
+            appendLabel(out, node);
+            out += ' ';
+            appendLabel(out, nodes.at(i + 1), true);
+            out += ')';
+            i++;
+        } else {
+            out += '(';
+            appendLabel(out, node);
+            openBrackets.push_back((int)i);
+        }
+    }
+
+    out.append(openBrackets.size(), ')');
+    return out;
+}
+
+namespace {
+    constexpr int UNLABELLED = -1;
+    constexpr int INSIDE_TRIANGLE = -2;
+
+    struct OpenBracket {
+        int node;
+        bool triangle = false;
+        // Set by the first word, even an empty one (a lone _), so an empty leaf isn't dropped
+        bool hasTriangleText = false;
+        std::string triangleText = "";
+        std::string triangleSubscript = "";
+    };
+
+    struct Token {
+        std::string label;
+        std::string subscript;
+        bool triangle = false;
+    };
+
+    class BracketReader {
+    public:
+        BracketReader(const std::string& text, size_t& pos) : _text(text), _pos(pos) {}
+
+        bool read(TreeSnapshot& tree) {
+            _tree = &tree;
+            _tree->nodes.clear();
+            _openBrackets.clear();
+
+            while (true) {
+                skipWhitespace();
+                if (_pos >= _text.size()) break;
+
+                const char c = _text[_pos];
+                if (c == '(') {
+                    _pos++;
+                    openBracket();
+                } else if (c == ')') {
+                    _pos++;
+                    if (_openBrackets.empty()) {
+                        pe::Logger::log("Unmatched ) in bracket notation at " + std::to_string(_pos - 1));
+                        return false;
+                    }
+
+                    closeBracket();
+                    if (_openBrackets.empty() && !_tree->nodes.empty()) return true;
+                } else {
+                    readToken();
+                    if (_openBrackets.empty()) {
+                        // A bare word on its own is a tree with a single node
+                        addNode(_token.label, _token.subscript, -1);
+                        return true;
+                    }
+                    addWord();
+                }
+
+                if (_failed) return false;
+            }
+
+            if (!_openBrackets.empty()) {
+                pe::Logger::log("Bracket notation ended with " + std::to_string(_openBrackets.size()) + " unclosed bracket(s)");
+                return false;
+            }
+            return !_tree->nodes.empty();
+        }
+    private:
+        const std::string& _text;
+        size_t& _pos;
+        TreeSnapshot* _tree = nullptr;
+
+        std::vector<OpenBracket> _openBrackets;
+        Token _token;
+        bool _failed = false;
+
+        std::unordered_map<std::string, s_p<const sf::String>> _labels;
+
+        void skipWhitespace() {
+            while (_pos < _text.size() && isWhitespace(_text[_pos])) _pos++;
+        }
+
+        void readToken() {
+            _token.label.clear();
+            _token.subscript.clear();
+            _token.triangle = false;
+
+            const size_t start = _pos;
+            bool escaped = false;
+            while (_pos < _text.size()) {
+                const char c = _text[_pos];
+                if (isWhitespace(c) || c == '(' || c == ')') break;
+
+                if (c == '\\' && _pos + 1 < _text.size()) {
+                    escaped = true;
+                    _pos++;
+                }
+                _pos++;
+            }
+
+            // Almost every token in a corpus is plain, so it can be copied in one go
+            if (!escaped) {
+                const size_t labelStart = _text[start] == '^' ? start + 1 : start;
+                _token.triangle = labelStart != start;
+
+                size_t subscriptStart = _pos;
+                while (subscriptStart > labelStart && _text[subscriptStart - 1] != '_') subscriptStart--;
+
+                if (subscriptStart > labelStart) {
+                    subscriptStart--;
+                    _token.label.assign(_text, labelStart, subscriptStart - labelStart);
+                    _token.subscript.assign(_text, subscriptStart + 1, _pos - subscriptStart - 1);
+                } else _token.label.assign(_text, labelStart, _pos - labelStart);
+                return;
+            }
+
+            const size_t end = _pos;
+            _pos = start;
+
+            size_t subscriptStart = std::string::npos;
+            std::string& token = _token.label;
+            while (_pos < end) {
+                const char c = _text[_pos];
+                if (c == '\\' && _pos + 1 < _text.size()) {
+                    token += _text[_pos + 1];
+                    _pos += 2;
+                    continue;
+                }
+
+                if (c == '^' && token.empty() && !_token.triangle) _token.triangle = true;
+                else {
+                    if (c == '_') subscriptStart = token.size();
+                    token += c;
+                }
+                _pos++;
+            }
+
+            if (subscriptStart != std::string::npos) {
+                _token.subscript = token.substr(subscriptStart + 1);
+                token.erase(subscriptStart);
+            }
+        }
+
+        int nearestNode() const {
+            for (auto it = _openBrackets.rbegin(); it != _openBrackets.rend(); it++) {
+                if (it->node >= 0) return it->node;
+            }
+            return -1;
+        }
+
+        bool insideTriangle() const {
+            return !_openBrackets.empty() && (_openBrackets.back().triangle || _openBrackets.back().node == INSIDE_TRIANGLE);
+        }
+
+        OpenBracket& enclosingTriangle() {
+            for (auto it = _openBrackets.rbegin(); it != _openBrackets.rend(); it++) {
+                if (it->triangle) return *it;
+            }
+            return _openBrackets.back();
+        }
+
+        void openBracket() {
+            skipWhitespace();
+            if (_pos >= _text.size() || _text[_pos] == '(' || _text[_pos] == ')') {
+                _openBrackets.push_back({ UNLABELLED });
+                return;
+            }
+
+            readToken();
+            if (insideTriangle()) {
+                // Structure under a triangle is flattened into its text
+                _openBrackets.push_back({ INSIDE_TRIANGLE });
+                return;
+            }
+
+            const int node = addNode(_token.label, _token.subscript, nearestNode());
+            _openBrackets.push_back({ node, _token.triangle });
+        }
+
+        void closeBracket() {
+            const OpenBracket bracket = std::move(_openBrackets.back());
+            _openBrackets.pop_back();
+
+            if (bracket.triangle && bracket.hasTriangleText) {
+                const int leaf = addNode(bracket.triangleText, bracket.triangleSubscript, bracket.node);
+                if (leaf >= 0) _tree->nodes.at(leaf).drawTriangle = true;
+            }
+        }
+
+        void addWord() {
+            if (insideTriangle()) {
+                OpenBracket& triangle = enclosingTriangle();
+                if (triangle.hasTriangleText) triangle.triangleText += ' ';
+                triangle.hasTriangleText = true;
+                triangle.triangleText += _token.label;
+                if (!_token.subscript.empty()) triangle.triangleSubscript = _token.subscript;
+                return;
+            }
+
+            addNode(_token.label, _token.subscript, nearestNode());
+        }
+
+        int addNode(const std::string& label, const std::string& subscript, int parent) {
+            if (parent == -1 && !_tree->nodes.empty()) {
+                pe::Logger::log("Bracket notation has more than one root at " + std::to_string(_pos));
+                _failed = true;
+                return -1;
+            }
+
+            SnapshotNode node;
+            node.text = intern(label);
+            if (!subscript.empty()) node.subscript = intern(subscript);
+            node.parent = parent;
+            _tree->nodes.push_back(node);
+            return (int)_tree->nodes.size() - 1;
+        }
+
+        s_p<const sf::String> intern(const std::string& utf8) {
+            const auto it = _labels.find(utf8);
+            if (it != _labels.end()) return it->second;
+
+            const auto label = std::make_shared<const sf::String>(sf::String::fromUtf8(utf8.begin(), utf8.end()));
+            _labels.emplace(utf8, label);
+            return label;
+        }
+    };
+}
+
+bool BracketNotation::read(const std::string& text, size_t& pos, TreeSnapshot& tree) {
+    BracketReader reader(text, pos);
+    return reader.read(tree);
+}
+
+bool BracketNotation::read(const std::string& text, TreeSnapshot& tree) {
+    size_t pos = 0;
+    return read(text, pos, tree);
+}
+
+bool BracketNotation::readAll(const std::string& text, std::vector<TreeSnapshot>& trees) {
+    size_t pos = 0;
+    BracketReader reader(text, pos);
+
+    while (true) {
+        TreeSnapshot tree;
+        if (!reader.read(tree)) break;
+        trees.push_back(std::move(tree));
+    }
+
+    // Anything other than trailing whitespace means a tree failed to parse
+    while (pos < text.size() && isWhitespace(text[pos])) pos++;
+    return pos == text.size();
+}
\ No newline at end of file
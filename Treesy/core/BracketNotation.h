@@ -0,0 +1,37 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _BRACKET_NOTATION_H
+#define _BRACKET_NOTATION_H
+
+#include <string>
+#include <vector>
+#include "TreeSnapshot.h"
+
+/*
+    Labelled bracket notation, e.g. (S (NP (D the) (N cat)) (VP sat))
+
+    Conventions:
+        NP_i            label NP with subscript i (split at the last _)
+        (^NP the cat)   NP drawn with a triangle over "the cat"
+        \( \) \_ \^ \\  literal characters, and "\ " for a space inside a label
+                        (a triangle's words are joined with single spaces, so
+                        only other whitespace is escaped there)
+
+    Unlabelled brackets, like the outer ( ) around each tree in Penn
+    Treebank files, are skipped. Text is UTF-8.
+*/
+class BracketNotation {
+public:
+    static std::string write(const TreeSnapshot& tree);
+
+    // Reads the next tree starting at pos and leaves pos just after it.
+    // Returns false if there was no tree left or the brackets didn't match
+    static bool read(const std::string& text, size_t& pos, TreeSnapshot& tree);
+    static bool read(const std::string& text, TreeSnapshot& tree);
+
+    // Reads every tree in a corpus. Labels are shared between all of the trees
+    static bool readAll(const std::string& text, std::vector<TreeSnapshot>& trees);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "Clipboard.h"
+#include <SFML/Window/Clipboard.hpp>
+#include "BracketNotation.h"
+#include "History.h"
+#include "../../PennyEngine/core/Logger.h"
+
+void ClipboardImpl::copy(VisualNode* node) {
+    _snapshot = std::make_shared<const TreeSnapshot>(TreeSnapshot::capture(node));
+    _snapshotText = BracketNotation::write(*_snapshot);
+    sf::Clipboard::setString(sf::String::fromUtf8(_snapshotText.begin(), _snapshotText.end()));
+}
+
+void ClipboardImpl::cut(VisualNode* node) {
+    if (!node->hasParent()) return;
+
+    copy(node);
+    History::recordRemoval(node);
+    node->hide();
+}
+
+bool ClipboardImpl::paste(VisualNode* parent) {
+    const auto utf8 = sf::Clipboard::getString().toUtf8();
+    const std::string text(utf8.begin(), utf8.end());
+
+    // Only fall back to the text if something else has been copied since
+    s_p<const TreeSnapshot> snapshot = _snapshot;
+    if (snapshot == nullptr || text != _snapshotText) {
+        TreeSnapshot parsed;
+        if (!BracketNotation::read(text, parsed)) {
+            pe::Logger::log("Clipboard does not contain a tree");
+            return false;
+        }
+        snapshot = std::make_shared<const TreeSnapshot>(std::move(parsed));
+    }
+
+    parent->setCollapsed(false);
+    const bool parentHadTriangle = parent->drawsTriangle();
+    const auto& root = snapshot->build(parent);
+    History::recordPaste(root.get(), parentHadTriangle);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _CLIPBOARD_H
+#define _CLIPBOARD_H
+
+#include <string>
+#include "TreeSnapshot.h"
+
+/*
+    Copies subtrees to the system clipboard as bracket notation, so they
+    can be pasted into other programs and trees can be pasted in from them.
+
+    The last copied subtree is also kept as a snapshot. Pasting it back
+    into Treesy uses the snapshot instead of re-parsing the text, which
+    keeps movement lines and curves and shares the label storage between
+    every paste.
+*/
+class ClipboardImpl {
+public:
+    void copy(VisualNode* node);
+    void cut(VisualNode* node);
+    bool paste(VisualNode* parent);
+private:
+    s_p<const TreeSnapshot> _snapshot = nullptr;
+    std::string _snapshotText;
+};
+
+class Clipboard {
+public:
+    static void copy(VisualNode* node) {
+        _instance.copy(node);
+    }
+
+    static void cut(VisualNode* node) {
+        _instance.cut(node);
+    }
+
+    static bool paste(VisualNode* parent) {
+        return _instance.paste(parent);
+    }
+private:
+    static inline ClipboardImpl _instance;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,214 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "Corpus.h"
+#include <fstream>
+#include <algorithm>
+#include "BracketNotation.h"
+#include "History.h"
+#include "../visual/VisualTree.h"
+#include "../../PennyEngine/ui/UI.h"
+#include "../../PennyEngine/ui/components/Panel.h"
+#include "../../PennyEngine/core/Logger.h"
+
+// Finds where each top level tree starts without parsing any of them
+static void indexTrees(const std::string& text, std::vector<size_t>& offsets) {
+    int depth = 0;
+    bool inWord = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        const char c = text[i];
+        if (c == '(') {
+            if (depth == 0) offsets.push_back(i);
+            depth++;
+            inWord = false;
+        } else if (c == ')') {
+            if (depth > 0) depth--;
+            inWord = false;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            inWord = false;
+        } else {
+            // A bare word outside of any brackets is a tree of its own
+            if (depth == 0 && !inWord) offsets.push_back(i);
+            inWord = true;
+            if (c == '\\') i++;
+        }
+    }
+}
+
+CorpusImpl::~CorpusImpl() {
+    close();
+}
+
+bool CorpusImpl::open(const std::string& path) {
+    close();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) {
+        pe::Logger::log("Could not open " + path);
+        return false;
+    }
+    _text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    in.close();
+
+    indexTrees(_text, _offsets);
+    if (_offsets.empty()) {
+        pe::Logger::log("Did not find a tree in " + path);
+        close();
+        return false;
+    }
+
+    _stopping = false;
+    _worker = std::thread(&CorpusImpl::run, this);
+    show(0);
+    return true;
+}
+
+void CorpusImpl::close() {
+    if (_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _worker.join();
+    }
+
+    _requested.clear();
+    _parsed.clear();
+    _offsets.clear();
+    _text.clear();
+    _index = 0;
+    _shown = false;
+    _unreadable = false;
+}
+
+bool CorpusImpl::isOpen() const {
+    return !_offsets.empty();
+}
+
+void CorpusImpl::update() {
+    if (!isOpen() || _shown) return;
+
+    s_p<const TreeSnapshot> tree = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _parsed.find(_index);
+        if (it == _parsed.end()) return;
+        tree = it->second;
+    }
+
+    _shown = true;
+
+    // A tree that can't be read leaves the current tree and its history as they are
+    if (tree->nodes.empty()) {
+        pe::Logger::log("Could not read tree " + std::to_string(_index + 1));
+        _unreadable = true;
+        updateTitle();
+        return;
+    }
+
+    // The previous tree stays up until the next one is ready to replace it
+    History::clear();
+    VisualTree::build(*tree);
+
+    updateTitle();
+}
+
+void CorpusImpl::show(size_t index) {
+    if (!isOpen()) return;
+
+    _index = std::min(index, _offsets.size() - 1);
+    _shown = false;
+    _unreadable = false;
+    prefetch();
+    updateTitle();
+}
+
+void CorpusImpl::next() {
+    if (_index + 1 < _offsets.size()) show(_index + 1);
+}
+
+void CorpusImpl::previous() {
+    if (_index > 0) show(_index - 1);
+}
+
+bool CorpusImpl::find(const std::string& query) {
+    if (!isOpen() || query.empty()) return false;
+
+    const size_t start = _index + 1 < _offsets.size() ? _offsets.at(_index + 1) : _text.size();
+    size_t match = _text.find(query, start);
+    if (match == std::string::npos) match = _text.find(query);
+    if (match == std::string::npos) return false;
+
+    const auto tree = std::upper_bound(_offsets.begin(), _offsets.end(), match);
+    show(tree == _offsets.begin() ? 0 : (tree - _offsets.begin()) - 1);
+    return true;
+}
+
+size_t CorpusImpl::getIndex() const {
+    return _index;
+}
+
+size_t CorpusImpl::getTreeCount() const {
+    return _offsets.size();
+}
+
+void CorpusImpl::prefetch() {
+    const size_t first = _index > CORPUS_PREFETCH_RADIUS ? _index - CORPUS_PREFETCH_RADIUS : 0;
+    const size_t last = std::min(_index + CORPUS_PREFETCH_RADIUS, _offsets.size() - 1);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _windowCenter = _index;
+
+        for (auto it = _parsed.begin(); it != _parsed.end();) {
+            if (it->first < first || it->first > last) it = _parsed.erase(it);
+            else it++;
+        }
+
+        // Nearest first, so the tree being shown is always parsed before its neighbours
+        _requested.clear();
+        for (size_t distance = 0; distance <= CORPUS_PREFETCH_RADIUS; distance++) {
+            if (_index + distance <= last && _parsed.find(_index + distance) == _parsed.end()) _requested.push_back(_index + distance);
+            if (distance != 0 && _index >= first + distance && _parsed.find(_index - distance) == _parsed.end()) _requested.push_back(_index - distance);
+        }
+    }
+    _wake.notify_one();
+}
+
+void CorpusImpl::run() {
+    while (true) {
+        size_t index = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this] { return _stopping || !_requested.empty(); });
+            if (_stopping) return;
+
+            index = _requested.front();
+            _requested.erase(_requested.begin());
+        }
+
+        // _text and _offsets don't change while the worker is running
+        TreeSnapshot tree;
+        size_t pos = _offsets.at(index);
+        if (!BracketNotation::read(_text, pos, tree)) tree.nodes.clear();
+        const auto snapshot = std::make_shared<const TreeSnapshot>(std::move(tree));
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        const size_t distance = index > _windowCenter ? index - _windowCenter : _windowCenter - index;
+        if (distance <= CORPUS_PREFETCH_RADIUS) _parsed[index] = snapshot;
+    }
+}
+
+void CorpusImpl::updateTitle() const {
+    const auto& menu = pe::UI::getMenu("corpus");
+    if (menu == nullptr) return;
+
+    const auto panel = std::dynamic_pointer_cast<pe::Panel>(menu->getComponent("corpusPanel"));
+    if (panel == nullptr) return;
+
+    std::string title = "Tree " + std::to_string(_index + 1) + " of " + std::to_string(_offsets.size());
+    if (!_shown) title += " (loading)";
+    else if (_unreadable) title += " (could not be read)";
+    panel->setTitle(title);
+}
\ No newline at end of file
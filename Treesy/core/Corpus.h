@@ -0,0 +1,117 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _CORPUS_H
+#define _CORPUS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "TreeSnapshot.h"
+
+// How many trees on either side of the current one are parsed ahead of time
+constexpr size_t CORPUS_PREFETCH_RADIUS = 2;
+
+/*
+    Browses a bracket notation file containing any number of trees.
+
+    Opening a file only finds where each tree starts. Trees are parsed
+    on a worker thread when they're needed: the current one first, then
+    its neighbours so stepping through the file doesn't have to wait.
+    Nodes are still created on the main thread, since they hold SFML
+    text that shares the font with everything else.
+
+    Edits to a tree aren't written back to the file; stepping away from
+    a tree discards them.
+*/
+class CorpusImpl {
+public:
+    ~CorpusImpl();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    void update();
+
+    void show(size_t index);
+    void next();
+    void previous();
+    // Shows the next tree after the current one whose text contains query, wrapping around
+    bool find(const std::string& query);
+
+    size_t getIndex() const;
+    size_t getTreeCount() const;
+private:
+    std::string _text;
+    std::vector<size_t> _offsets;
+
+    size_t _index = 0;
+    bool _shown = false;
+    // The tree at _index couldn't be read, so the canvas still shows the one before it
+    bool _unreadable = false;
+
+    std::thread _worker;
+    bool _stopping = false;
+
+    // Guards everything below, which is shared with the worker
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    size_t _windowCenter = 0;
+    std::vector<size_t> _requested;
+    std::unordered_map<size_t, s_p<const TreeSnapshot>> _parsed;
+
+    void prefetch();
+    void run();
+    void updateTitle() const;
+};
+
+class Corpus {
+public:
+    static bool open(const std::string& path) {
+        return _instance.open(path);
+    }
+
+    static void close() {
+        _instance.close();
+    }
+
+    static bool isOpen() {
+        return _instance.isOpen();
+    }
+
+    static void update() {
+        _instance.update();
+    }
+
+    static void show(size_t index) {
+        _instance.show(index);
+    }
+
+    static void next() {
+        _instance.next();
+    }
+
+    static void previous() {
+        _instance.previous();
+    }
+
+    static bool find(const std::string& query) {
+        return _instance.find(query);
+    }
+
+    static size_t getIndex() {
+        return _instance.getIndex();
+    }
+
+    static size_t getTreeCount() {
+        return _instance.getTreeCount();
+    }
+private:
+    static inline CorpusImpl _instance;
+};
+
+#endif
\ No newline at end of file
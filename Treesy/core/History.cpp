@@ -0,0 +1,247 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "History.h"
+#include <algorithm>
+#include <unordered_set>
+#include "../visual/VisualTree.h"
+#include "LabelIndex.h"
+
+void HistoryImpl::recordAddition(VisualNode* node, bool parentHadTriangle) {
+    Edit edit;
+    edit.type = EDIT_TYPE::ADD_NODE;
+    edit.node = node->shared_from_this();
+    edit.parentHadTriangle = parentHadTriangle;
+
+    const auto& siblings = node->getParent()->getChildren();
+    edit.index = std::find(siblings.begin(), siblings.end(), edit.node) - siblings.begin();
+
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordPaste(VisualNode* node, bool parentHadTriangle) {
+    Edit edit;
+    edit.type = EDIT_TYPE::ADD_SUBTREE;
+    edit.node = node->shared_from_this();
+    edit.parentHadTriangle = parentHadTriangle;
+    captureSubtree(edit);
+
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordRemoval(VisualNode* node) {
+    Edit edit;
+    edit.type = EDIT_TYPE::REMOVE_SUBTREE;
+    edit.node = node->shared_from_this();
+    captureSubtree(edit);
+
+    std::unordered_set<VisualNode*> removedNodes;
+    for (const auto& [removedNode, children] : edit.subtree) {
+        removedNodes.insert(removedNode.get());
+    }
+
+    for (const auto& other : VisualTree::getNodes()) {
+        if (other->hasMovement() && removedNodes.count(other->_endPointNode.get()) && !removedNodes.count(other.get())) {
+            edit.incomingMovements.push_back({ other, other->getMovementState() });
+        }
+    }
+
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordTextChange(VisualNode* node, const sf::String& before) {
+    const sf::String& after = node->getText().getString();
+    if (after == before) return;
+    LabelIndex::updateNode(node);
+
+    // Typing into the same node is one step, not one step per character
+    if (_redoStack.empty() && !_undoStack.empty() 
+        && _undoStack.back().type == EDIT_TYPE::SET_TEXT && _undoStack.back().node.get() == node) {
+        _undoStack.back().after = after;
+        if (_undoStack.back().after == _undoStack.back().before) _undoStack.pop_back();
+        return;
+    }
+
+    Edit edit;
+    edit.type = EDIT_TYPE::SET_TEXT;
+    edit.node = node->shared_from_this();
+    edit.before = before;
+    edit.after = after;
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordSubscriptChange(VisualNode* node, const sf::String& before) {
+    const sf::String& after = node->_subscript.getString();
+    if (after == before) return;
+    LabelIndex::updateNode(node);
+
+    Edit edit;
+    edit.type = EDIT_TYPE::SET_SUBSCRIPT;
+    edit.node = node->shared_from_this();
+    edit.before = before;
+    edit.after = after;
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordTriangleToggle(VisualNode* node) {
+    Edit edit;
+    edit.type = EDIT_TYPE::TOGGLE_TRIANGLE;
+    edit.node = node->shared_from_this();
+    push(std::move(edit));
+}
+
+void HistoryImpl::recordMovementChange(VisualNode* node, const MovementState& before) {
+    Edit edit;
+    edit.type = EDIT_TYPE::SET_MOVEMENT;
+    edit.node = node->shared_from_this();
+    edit.movementBefore = before;
+    edit.movementAfter = node->getMovementState();
+    push(std::move(edit));
+}
+
+bool HistoryImpl::undo() {
+    if (_undoStack.empty()) return false;
+
+    revert(_undoStack.back());
+    _redoStack.push_back(std::move(_undoStack.back()));
+    _undoStack.pop_back();
+    return true;
+}
+
+bool HistoryImpl::redo() {
+    if (_redoStack.empty()) return false;
+
+    apply(_redoStack.back());
+    _undoStack.push_back(std::move(_redoStack.back()));
+    _redoStack.pop_back();
+    return true;
+}
+
+void HistoryImpl::clear() {
+    _undoStack.clear();
+    _redoStack.clear();
+}
+
+void HistoryImpl::push(Edit edit) {
+    _redoStack.clear();
+    _undoStack.push_back(std::move(edit));
+    if (_undoStack.size() > MAX_HISTORY_SIZE) _undoStack.pop_front();
+}
+
+void HistoryImpl::captureSubtree(Edit& edit) {
+    const auto& siblings = edit.node->getParent()->getChildren();
+    edit.index = std::find(siblings.begin(), siblings.end(), edit.node) - siblings.begin();
+
+    // A removed subtree is torn down over the next few updates, so its structure has to be captured up front
+    std::vector<s_p<VisualNode>> stack = { edit.node };
+    while (!stack.empty()) {
+        const s_p<VisualNode> current = stack.back();
+        stack.pop_back();
+
+        edit.subtree.push_back({ current, current->getChildren() });
+        for (const auto& child : current->getChildren()) {
+            stack.push_back(child);
+        }
+    }
+}
+
+void HistoryImpl::restoreSubtree(Edit& edit) {
+    for (const auto& [node, children] : edit.subtree) {
+        node->_children = children;
+        node->show();
+        VisualTree::_instance.restoreNode(node);
+    }
+    insertChild(edit.node->getParent(), edit.node, edit.index);
+}
+
+void HistoryImpl::apply(Edit& edit) {
+    VisualNode* node = edit.node.get();
+    switch (edit.type) {
+        case EDIT_TYPE::ADD_NODE:
+            node->show();
+            insertChild(node->getParent(), edit.node, edit.index);
+            node->getParent()->_drawTriangle = false;
+            VisualTree::_instance.restoreNode(edit.node);
+            break;
+        case EDIT_TYPE::ADD_SUBTREE:
+            restoreSubtree(edit);
+            node->getParent()->_drawTriangle = false;
+            break;
+        case EDIT_TYPE::REMOVE_SUBTREE:
+            // The rest of the subtree follows the same way it did the first time
+            node->hide();
+            break;
+        case EDIT_TYPE::SET_TEXT:
+            node->getText().setString(edit.after);
+            LabelIndex::updateNode(node);
+            break;
+        case EDIT_TYPE::SET_SUBSCRIPT:
+            node->_subscript.setString(edit.after);
+            LabelIndex::updateNode(node);
+            break;
+        case EDIT_TYPE::TOGGLE_TRIANGLE:
+            node->_drawTriangle = !node->_drawTriangle;
+            break;
+        case EDIT_TYPE::SET_MOVEMENT:
+            setMovementState(node, edit.movementAfter);
+            break;
+    }
+}
+
+void HistoryImpl::revert(Edit& edit) {
+    VisualNode* node = edit.node.get();
+    switch (edit.type) {
+        case EDIT_TYPE::ADD_NODE:
+            removeChild(node->getParent(), node);
+            node->hide();
+            node->getParent()->_drawTriangle = edit.parentHadTriangle;
+            break;
+        case EDIT_TYPE::ADD_SUBTREE:
+            node->hide();
+            node->getParent()->_drawTriangle = edit.parentHadTriangle;
+            break;
+        case EDIT_TYPE::REMOVE_SUBTREE:
+            restoreSubtree(edit);
+            for (const auto& [otherNode, movement] : edit.incomingMovements) {
+                setMovementState(otherNode.get(), movement);
+            }
+            break;
+        case EDIT_TYPE::SET_TEXT:
+            node->getText().setString(edit.before);
+            LabelIndex::updateNode(node);
+            break;
+        case EDIT_TYPE::SET_SUBSCRIPT:
+            node->_subscript.setString(edit.before);
+            LabelIndex::updateNode(node);
+            break;
+        case EDIT_TYPE::TOGGLE_TRIANGLE:
+            node->_drawTriangle = !node->_drawTriangle;
+            break;
+        case EDIT_TYPE::SET_MOVEMENT:
+            setMovementState(node, edit.movementBefore);
+            break;
+    }
+}
+
+void HistoryImpl::setMovementState(VisualNode* node, const MovementState& state) {
+    node->_hasMovement = state.hasMovement;
+    node->_endPointNode = state.endPointNode;
+    node->_curveAngle = state.curveAngle;
+    node->_curveHeight = state.curveHeight;
+    node->_selectingMovement = false;
+}
+
+void HistoryImpl::insertChild(VisualNode* parent, const s_p<VisualNode>& child, size_t index) {
+    auto& children = parent->_children;
+    // The parent may not have pruned the child yet if it was removed this frame
+    if (std::find(children.begin(), children.end(), child) == children.end()) {
+        children.insert(children.begin() + std::min(index, children.size()), child);
+    }
+    child->updateHiddenState();
+}
+
+void HistoryImpl::removeChild(VisualNode* parent, VisualNode* child) {
+    auto& children = parent->_children;
+    children.erase(std::remove_if(children.begin(), children.end(), 
+        [child](const s_p<VisualNode>& node) { return node.get() == child; }), children.end());
+}
\ No newline at end of file
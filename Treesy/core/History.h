@@ -0,0 +1,128 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _HISTORY_H
+#define _HISTORY_H
+
+#include <deque>
+#include <vector>
+#include <SFML/System/String.hpp>
+#include "../../PennyEngine/core/Defines.h"
+#include "../visual/VisualNode.h"
+
+constexpr size_t MAX_HISTORY_SIZE = 10000;
+
+enum class EDIT_TYPE {
+    ADD_NODE,
+    ADD_SUBTREE,
+    REMOVE_SUBTREE,
+    SET_TEXT,
+    SET_SUBSCRIPT,
+    TOGGLE_TRIANGLE,
+    SET_MOVEMENT
+};
+
+// One undoable step. Only the fields its type uses are filled in, and it only
+// holds on to the nodes it changed, so a step costs memory proportional to
+// the edit rather than to the size of the tree
+struct Edit {
+    EDIT_TYPE type;
+    s_p<VisualNode> node;
+
+    // ADD_NODE, ADD_SUBTREE, REMOVE_SUBTREE: position among the parent's children
+    size_t index = 0;
+    // ADD_NODE, ADD_SUBTREE: adding a child removes the parent's triangle
+    bool parentHadTriangle = false;
+
+    // ADD_SUBTREE, REMOVE_SUBTREE: every node in the subtree along with its children at the time
+    std::vector<std::pair<s_p<VisualNode>, std::vector<s_p<VisualNode>>>> subtree;
+    // REMOVE_SUBTREE: movement lines from outside the subtree that pointed into it
+    std::vector<std::pair<s_p<VisualNode>, MovementState>> incomingMovements;
+
+    // SET_TEXT, SET_SUBSCRIPT
+    sf::String before;
+    sf::String after;
+
+    // SET_MOVEMENT
+    MovementState movementBefore;
+    MovementState movementAfter;
+};
+
+class HistoryImpl {
+public:
+    void recordAddition(VisualNode* node, bool parentHadTriangle);
+    void recordPaste(VisualNode* node, bool parentHadTriangle);
+    void recordRemoval(VisualNode* node);
+    void recordTextChange(VisualNode* node, const sf::String& before);
+    void recordSubscriptChange(VisualNode* node, const sf::String& before);
+    void recordTriangleToggle(VisualNode* node);
+    void recordMovementChange(VisualNode* node, const MovementState& before);
+
+    bool undo();
+    bool redo();
+
+    void clear();
+private:
+    std::deque<Edit> _undoStack;
+    std::vector<Edit> _redoStack;
+
+    void push(Edit edit);
+
+    static void captureSubtree(Edit& edit);
+    static void restoreSubtree(Edit& edit);
+
+    void apply(Edit& edit);
+    void revert(Edit& edit);
+
+    static void setMovementState(VisualNode* node, const MovementState& state);
+
+    static void insertChild(VisualNode* parent, const s_p<VisualNode>& child, size_t index);
+    static void removeChild(VisualNode* parent, VisualNode* child);
+};
+
+class History {
+public:
+    static void recordAddition(VisualNode* node, bool parentHadTriangle) {
+        _instance.recordAddition(node, parentHadTriangle);
+    }
+
+    static void recordPaste(VisualNode* node, bool parentHadTriangle) {
+        _instance.recordPaste(node, parentHadTriangle);
+    }
+
+    static void recordRemoval(VisualNode* node) {
+        _instance.recordRemoval(node);
+    }
+
+    static void recordTextChange(VisualNode* node, const sf::String& before) {
+        _instance.recordTextChange(node, before);
+    }
+
+    static void recordSubscriptChange(VisualNode* node, const sf::String& before) {
+        _instance.recordSubscriptChange(node, before);
+    }
+
+    static void recordTriangleToggle(VisualNode* node) {
+        _instance.recordTriangleToggle(node);
+    }
+
+    static void recordMovementChange(VisualNode* node, const MovementState& before) {
+        _instance.recordMovementChange(node, before);
+    }
+
+    static bool undo() {
+        return _instance.undo();
+    }
+
+    static bool redo() {
+        return _instance.redo();
+    }
+
+    static void clear() {
+        _instance.clear();
+    }
+private:
+    static inline HistoryImpl _instance;
+};
+
+#endif
\ No newline at end of file
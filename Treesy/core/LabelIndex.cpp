@@ -0,0 +1,278 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "LabelIndex.h"
+#include <regex>
+#include <algorithm>
+#include <cctype>
+#include "../../PennyEngine/PennyEngine.h"
+#include "../../PennyEngine/ui/UI.h"
+#include "../../PennyEngine/ui/components/Panel.h"
+#include "../../PennyEngine/ui/components/ToggleButton.h"
+
+std::string LabelIndexImpl::toToken(const sf::String& text) {
+    const auto utf8 = text.toUtf8();
+    std::string token(utf8.begin(), utf8.end());
+    // Only ASCII is folded, which leaves multibyte characters intact
+    for (char& c : token) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return token;
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static std::vector<std::string> splitWords(const std::string& text) {
+    std::vector<std::string> words;
+    size_t start = 0;
+    while (start < text.size()) {
+        while (start < text.size() && isSpace(text[start])) start++;
+        size_t end = start;
+        while (end < text.size() && !isSpace(text[end])) end++;
+        if (end > start) words.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return words;
+}
+
+void LabelIndexImpl::addToken(std::map<std::string, std::unordered_set<const VisualNode*>>& index, const std::string& token, const VisualNode* node) {
+    if (token.empty()) return;
+    index[token].insert(node);
+}
+
+void LabelIndexImpl::removeToken(std::map<std::string, std::unordered_set<const VisualNode*>>& index, const std::string& token, const VisualNode* node) {
+    const auto it = index.find(token);
+    if (it == index.end()) return;
+
+    it->second.erase(node);
+    if (it->second.empty()) index.erase(it);
+}
+
+void LabelIndexImpl::indexEntry(const IndexedNode& entry, const VisualNode* node, bool add) {
+    for (const std::string* text : { &entry.label, &entry.subscript }) {
+        if (add) addToken(_texts, *text, node);
+        else removeToken(_texts, *text, node);
+
+        for (const auto& word : splitWords(*text)) {
+            if (add) addToken(_tokens, word, node);
+            else removeToken(_tokens, word, node);
+        }
+    }
+}
+
+void LabelIndexImpl::updateNode(VisualNode* node) {
+    const std::string label = toToken(node->getText().getString());
+    const std::string subscript = toToken(node->_subscript.getString());
+
+    auto it = _entries.find(node);
+    if (it == _entries.end()) {
+        it = _entries.emplace(node, IndexedNode{ node->shared_from_this(), "", "" }).first;
+    } else if (it->second.label == label && it->second.subscript == subscript) {
+        return;
+    }
+
+    IndexedNode& entry = it->second;
+    indexEntry(entry, node, false);
+    entry.label = label;
+    entry.subscript = subscript;
+    indexEntry(entry, node, true);
+
+    _revision++;
+}
+
+void LabelIndexImpl::removeNode(const VisualNode* node) {
+    const auto it = _entries.find(node);
+    if (it == _entries.end()) return;
+
+    // Erasing the entry also lets go of the node, so its pool slot can be reused
+    indexEntry(it->second, node, false);
+    _entries.erase(it);
+    _revision++;
+}
+
+void LabelIndexImpl::rebuild(const std::vector<s_p<VisualNode>>& nodes) {
+    clear();
+    _entries.reserve(nodes.size());
+    for (const auto& node : nodes) {
+        updateNode(node.get());
+    }
+}
+
+void LabelIndexImpl::clear() {
+    setHighlights(false);
+    _entries.clear();
+    _tokens.clear();
+    _texts.clear();
+    _results.clear();
+    _current = 0;
+    _pendingJump = false;
+    _revision++;
+}
+
+void LabelIndexImpl::update() {
+    const auto& menu = pe::UI::getMenu("search");
+    if (menu == nullptr || !menu->isActive()) return;
+
+    // Searches as the query is typed, and again when edits to the tree might change the results
+    const auto utf8 = menu->getComponent("searchField")->getText().getString().toUtf8();
+    const std::string query(utf8.begin(), utf8.end());
+    const auto regexButton = std::dynamic_pointer_cast<pe::ToggleButton>(menu->getComponent("search_regex"));
+    const bool regex = regexButton != nullptr && regexButton->getValue();
+    if (query != _query || regex != _regex) {
+        find(query, regex);
+    } else if (_revision != _searchedRevision) {
+        // Only the tree changed, so the place in the results is kept and the camera stays where it is
+        const size_t current = _current;
+        search(query, regex);
+        if (!_results.empty()) markCurrent(std::min(current, _results.size() - 1));
+        updateTitle();
+    }
+
+    if (_pendingJump) jumpToCurrent();
+}
+
+void LabelIndexImpl::collect(const std::unordered_set<const VisualNode*>& nodes, std::unordered_set<const VisualNode*>& found, std::vector<s_p<VisualNode>>& matches) {
+    for (const VisualNode* node : nodes) {
+        if (!found.insert(node).second) continue;
+
+        const auto it = _entries.find(node);
+        if (it == _entries.end()) continue;
+
+        const s_p<VisualNode> match = it->second.node.lock();
+        if (match != nullptr && match.get() == node && match->isActive()) matches.push_back(match);
+    }
+}
+
+size_t LabelIndexImpl::find(const std::string& query, bool regex) {
+    search(query, regex);
+    if (!_results.empty()) select(0);
+    else updateTitle();
+
+    return _results.size();
+}
+
+void LabelIndexImpl::search(const std::string& query, bool regex) {
+    setHighlights(false);
+    _results.clear();
+    _current = 0;
+    _query = query;
+    _regex = regex;
+    _invalidQuery = false;
+    _searchedRevision = _revision;
+
+    const std::string token = toToken(sf::String::fromUtf8(query.begin(), query.end()));
+    if (token.empty()) return;
+
+    std::unordered_set<const VisualNode*> found;
+    std::vector<s_p<VisualNode>> matches;
+    if (regex) {
+        try {
+            // The query isn't folded like the tokens are, since that would change escapes like \W
+            const std::regex pattern(query, std::regex::icase);
+            for (const auto& [candidate, nodes] : _texts) {
+                if (std::regex_search(candidate, pattern)) collect(nodes, found, matches);
+            }
+        } catch (const std::regex_error&) {
+            // Most likely still being typed, so this only shows in the title
+            _invalidQuery = true;
+        }
+    } else {
+        // Words never have spaces in them, so a query that does is matched against whole labels
+        const auto& index = std::any_of(token.begin(), token.end(), isSpace) ? _texts : _tokens;
+        for (auto it = index.lower_bound(token); it != index.end() && it->first.compare(0, token.size(), token) == 0; ++it) {
+            collect(it->second, found, matches);
+        }
+    }
+
+    // Reading order, so stepping through the results moves across and down the tree
+    std::sort(matches.begin(), matches.end(), [](const s_p<VisualNode>& a, const s_p<VisualNode>& b) {
+        if (a->getPosition().y != b->getPosition().y) return a->getPosition().y < b->getPosition().y;
+        return a->getPosition().x < b->getPosition().x;
+    });
+
+    _results.assign(matches.begin(), matches.end());
+    setHighlights(true);
+}
+
+void LabelIndexImpl::next() {
+    if (_results.empty()) return;
+    select((_current + 1) % _results.size());
+}
+
+void LabelIndexImpl::previous() {
+    if (_results.empty()) return;
+    select((_current + _results.size() - 1) % _results.size());
+}
+
+void LabelIndexImpl::clearResults() {
+    setHighlights(false);
+    _results.clear();
+    _current = 0;
+    _query.clear();
+    _pendingJump = false;
+}
+
+size_t LabelIndexImpl::getResultCount() const {
+    return _results.size();
+}
+
+void LabelIndexImpl::setHighlights(bool highlighted) {
+    for (size_t i = 0; i < _results.size(); i++) {
+        const auto node = _results.at(i).lock();
+        if (node == nullptr) continue;
+
+        node->_isSearchMatch = highlighted;
+        node->_isCurrentSearchMatch = false;
+    }
+}
+
+void LabelIndexImpl::markCurrent(size_t index) {
+    if (_current < _results.size()) {
+        if (const auto previous = _results.at(_current).lock()) previous->_isCurrentSearchMatch = false;
+    }
+    _current = index;
+
+    if (const auto node = _results.at(_current).lock()) node->_isCurrentSearchMatch = true;
+}
+
+void LabelIndexImpl::select(size_t index) {
+    markCurrent(index);
+
+    const auto node = _results.at(_current).lock();
+    if (node != nullptr) {
+        // Matches inside collapsed subtrees are shown by expanding everything above them
+        for (VisualNode* ancestor = node->getParent(); ancestor != nullptr; ancestor = ancestor->getParent()) {
+            ancestor->setCollapsed(false);
+        }
+    }
+
+    // Waits for the next layout, since expanding can move the match
+    _pendingJump = true;
+    updateTitle();
+}
+
+void LabelIndexImpl::jumpToCurrent() {
+    _pendingJump = false;
+    if (_current >= _results.size()) return;
+
+    const auto node = _results.at(_current).lock();
+    if (node == nullptr || !node->isActive()) return;
+
+    const sf::FloatRect bounds = node->getBounds();
+    PennyEngine::getCamera().setCenter(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
+}
+
+void LabelIndexImpl::updateTitle() const {
+    const auto& menu = pe::UI::getMenu("search");
+    if (menu == nullptr) return;
+
+    const auto panel = std::dynamic_pointer_cast<pe::Panel>(menu->getComponent("searchPanel"));
+    if (panel == nullptr) return;
+
+    if (_invalidQuery) panel->setTitle("Invalid pattern");
+    else if (_query.empty()) panel->setTitle("Find nodes");
+    else if (_results.empty()) panel->setTitle("No matches");
+    else panel->setTitle("Match " + std::to_string(_current + 1) + " of " + std::to_string(_results.size()));
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _LABEL_INDEX_H
+#define _LABEL_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include "../visual/VisualNode.h"
+
+/*
+    Finds nodes by label or subscript.
+
+    Every word of every node's label and subscript is kept in a sorted
+    index from word to nodes, updated as nodes are added, edited and
+    removed, so a search looks at each distinct word once rather than at
+    every node. Prefix searches only visit the words that start with the
+    query, so "cat" finds a triangle labelled "the cat". A query with a
+    space in it is matched against whole labels instead, and regex
+    searches always are. Text is compared without case.
+*/
+class LabelIndexImpl {
+public:
+    // Indexes node, or catches its entry up with its current text
+    void updateNode(VisualNode* node);
+    // Drops a node that has left the tree
+    void removeNode(const VisualNode* node);
+    // Replaces the whole index with nodes
+    void rebuild(const std::vector<s_p<VisualNode>>& nodes);
+    void clear();
+
+    // Searches again if the query or the tree has changed, and moves the camera to a match once it's been laid out
+    void update();
+
+    // Returns how many nodes matched. Matches are highlighted and the camera moves to the first
+    size_t find(const std::string& query, bool regex);
+    void next();
+    void previous();
+    void clearResults();
+
+    size_t getResultCount() const;
+
+    friend class BenchmarkManager;
+private:
+    struct IndexedNode {
+        std::weak_ptr<VisualNode> node;
+        std::string label;
+        std::string subscript;
+    };
+
+    std::unordered_map<const VisualNode*, IndexedNode> _entries;
+    // Single words, for prefix searches
+    std::map<std::string, std::unordered_set<const VisualNode*>> _tokens;
+    // Whole labels and subscripts, for regexes and queries with spaces in them
+    std::map<std::string, std::unordered_set<const VisualNode*>> _texts;
+    // Bumped on every change so open searches know to run again
+    unsigned int _revision = 0;
+
+    std::string _query;
+    bool _regex = false;
+    bool _invalidQuery = false;
+    unsigned int _searchedRevision = 0;
+
+    std::vector<std::weak_ptr<VisualNode>> _results;
+    size_t _current = 0;
+    bool _pendingJump = false;
+
+    static std::string toToken(const sf::String& text);
+    static void addToken(std::map<std::string, std::unordered_set<const VisualNode*>>& index, const std::string& token, const VisualNode* node);
+    static void removeToken(std::map<std::string, std::unordered_set<const VisualNode*>>& index, const std::string& token, const VisualNode* node);
+    // Adds or removes the entry's words and whole texts
+    void indexEntry(const IndexedNode& entry, const VisualNode* node, bool add);
+
+    // Fills the results and highlights them without moving the camera
+    void search(const std::string& query, bool regex);
+    void collect(const std::unordered_set<const VisualNode*>& nodes, std::unordered_set<const VisualNode*>& found, std::vector<s_p<VisualNode>>& matches);
+    void setHighlights(bool highlighted);
+    void markCurrent(size_t index);
+    void select(size_t index);
+    void jumpToCurrent();
+    void updateTitle() const;
+};
+
+class LabelIndex {
+public:
+    static void updateNode(VisualNode* node) {
+        _instance.updateNode(node);
+    }
+
+    static void removeNode(const VisualNode* node) {
+        _instance.removeNode(node);
+    }
+
+    static void rebuild(const std::vector<s_p<VisualNode>>& nodes) {
+        _instance.rebuild(nodes);
+    }
+
+    static void clear() {
+        _instance.clear();
+    }
+
+    static void update() {
+        _instance.update();
+    }
+
+    static size_t find(const std::string& query, bool regex) {
+        return _instance.find(query, regex);
+    }
+
+    static void next() {
+        _instance.next();
+    }
+
+    static void previous() {
+        _instance.previous();
+    }
+
+    static void clearResults() {
+        _instance.clearResults();
+    }
+
+    static size_t getResultCount() {
+        return _instance.getResultCount();
+    }
+
+    friend class BenchmarkManager;
+private:
+    static inline LabelIndexImpl _instance;
+};
+
+#endif
\ No newline at end of file
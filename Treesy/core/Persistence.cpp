@@ -6,14 +6,23 @@
 #include "../../PennyEngine/core/Logger.h"
 #include "../visual/VisualTree.h"
 #include <fstream>
+#include <algorithm>
 #include <iostream>
+#include <charconv>
 #include "Versioning.h"
+#include "BracketNotation.h"
 
 static void write(std::ofstream& out, std::string output) {
     output += "\n";
     out.write(output.data(), output.size());
 }
 
+static std::string idToString(NodeId id) {
+    char buffer[16];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), id, 16);
+    return std::string(buffer, result.ptr);
+}
+
 void PersistenceImpl::save(std::string path) {
     std::ofstream out(path, std::ios::binary);
 
@@ -22,15 +31,15 @@ void PersistenceImpl::save(std::string path) {
     const auto& nodes = VisualTree::getNodes();
     for (const auto& node : nodes) {
         write(out, "{");
-        write(out, "id: " + node->getIdentifier());
+        write(out, "id: " + idToString(node->getId()));
         const auto& res = PennyEngine::getRenderResolution();
         write(out, "pos: " + std::to_string(node->getPosition().x / res.width * 100.f) + ", " + std::to_string(node->getPosition().y / res.height * 100.f));
-        if (node->hasParent()) write(out, "parent: " + node->getParent()->getIdentifier());
+        if (node->hasParent()) write(out, "parent: " + idToString(node->getParent()->getId()));
         if (node->hasChildren()) {
             out << "children: ";
             for (int i = 0; i < node->getChildren().size(); i++) {
                 const auto& child = node->getChildren().at(i);
-                out << child->getIdentifier() + std::string(i < node->getChildren().size() - 1 ? ", " : "");
+                out << idToString(child->getId()) + std::string(i < node->getChildren().size() - 1 ? ", " : "");
             }
             out << std::endl;
         }
@@ -39,7 +48,7 @@ void PersistenceImpl::save(std::string path) {
         write(out, "text: \"" + utf8Str + "\"");
         write(out, "subs: \"" + node->getSubscript() + "\"");
         write(out, "hasMovement: " + std::string(node->hasMovement() ? "true" : "false"));
-        if (node->hasMovement()) write(out, "endPointNode: " + node->_endPointNode->getIdentifier());
+        if (node->hasMovement()) write(out, "endPointNode: " + idToString(node->_endPointNode->getId()));
         write(out, "curveAngle: " + std::to_string(node->_curveAngle));
         write(out, "curveHeight: " + std::to_string(node->_curveHeight));
         write(out, "triangle: " + std::string(node->_drawTriangle ? "true" : "false"));
@@ -49,7 +58,12 @@ void PersistenceImpl::save(std::string path) {
     out.close();
 }
 
-void PersistenceImpl::load(std::string path, bool convert) {
+void PersistenceImpl::load(std::string path) {
+    TreeSnapshot tree;
+    if (read(path, tree)) VisualTree::build(tree);
+}
+
+bool PersistenceImpl::read(std::string path, TreeSnapshot& tree, bool convert) {
     std::ifstream in(path, convert ? std::ios::in : std::ios::binary);
 
     if (in.good()) {
@@ -58,15 +72,13 @@ void PersistenceImpl::load(std::string path, bool convert) {
             input.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
             std::vector<std::string> lines = pe::splitString(input, "\n");
 
-            bool foundVersion = false;
             bool readingNode = false;
             std::vector<std::string> nodeLines;
             for (std::string line : lines) {
                 if (!readingNode && line == "{") readingNode = true;
-                else if (!readingNode && pe::stringStartsWith(line, "VERSION:")) foundVersion = true;
                 else if (readingNode && line == "}") {
                     readingNode = false;
-                    createNode(nodeLines, !foundVersion);
+                    createNode(nodeLines);
                     nodeLines.clear();
                 } else if (readingNode) nodeLines.push_back(line);
             }
@@ -76,124 +88,118 @@ void PersistenceImpl::load(std::string path, bool convert) {
     }
     in.close();
 
-    for (const auto& pair : _children) {
-        const auto& parent = findNode(pair.first);
-        if (parent == nullptr) {
-            pe::Logger::log("Did not find parent " + pair.first);
-            continue;
+    tree = orderLoadedNodes();
+    _loadedNodes.clear();
+    _loadedNodeIndices.clear();
+
+    if (tree.nodes.empty()) {
+        if (!convert) {
+            pe::Logger::log("No nodes were created; attempting to convert file from older version.");
+            return read(path, tree, true);
         }
+        return false;
+    }
 
-        for (const auto& childId : pair.second) {
-            const auto& child = findNode(childId);
-            if (child == nullptr) {
-                pe::Logger::log("Did not find child " + childId + " of parent " + pair.first);
+    return true;
+}
+
+TreeSnapshot PersistenceImpl::orderLoadedNodes() const {
+    TreeSnapshot tree;
+    tree.nodes.reserve(_loadedNodes.size());
+
+    const auto root = std::find_if(_loadedNodes.begin(), _loadedNodes.end(), [](const LoadedNode& node) { return node.parent.empty(); });
+    if (root == _loadedNodes.end()) {
+        if (!_loadedNodes.empty()) pe::Logger::log("Did not find a root node");
+        return tree;
+    }
+
+    std::vector<int> snapshotIndices(_loadedNodes.size(), -1);
+    std::vector<std::pair<size_t, int>> stack = { { root - _loadedNodes.begin(), -1 } };
+    while (!stack.empty()) {
+        const auto [index, parent] = stack.back();
+        stack.pop_back();
+
+        // Already placed, if a file lists a node as a child more than once
+        if (snapshotIndices.at(index) != -1) continue;
+
+        const auto& loaded = _loadedNodes.at(index);
+        snapshotIndices.at(index) = (int)tree.nodes.size();
+        tree.nodes.push_back(loaded.node);
+        tree.nodes.back().parent = parent;
+
+        // Pushed in reverse so they're visited left to right
+        for (auto it = loaded.children.rbegin(); it != loaded.children.rend(); it++) {
+            const auto child = _loadedNodeIndices.find(*it);
+            if (child == _loadedNodeIndices.end()) {
+                pe::Logger::log("Did not find child " + *it + " of parent " + loaded.id);
                 continue;
             }
-
-            parent->_children.push_back(child);
+            stack.push_back({ child->second, snapshotIndices.at(index) });
         }
     }
 
-    for (const auto& pair : _endPoints) {
-        const auto& startNode = findNode(pair.first);
-        const auto& endNode = findNode(pair.second);
-
-        if (startNode == nullptr) {
-            pe::Logger::log("Did not find startNode " + pair.first);
+    for (size_t i = 0; i < _loadedNodes.size(); i++) {
+        const auto& loaded = _loadedNodes.at(i);
+        if (snapshotIndices.at(i) == -1) {
+            pe::Logger::log("Node " + loaded.id + " is not connected to the tree");
             continue;
         }
+        if (!loaded.hasMovement) continue;
 
-        if (endNode == nullptr) {
-            pe::Logger::log("Did not find endNode + " + pair.second + " for startNode " + pair.first);
+        const auto endNode = _loadedNodeIndices.find(loaded.endPointNode);
+        if (endNode == _loadedNodeIndices.end() || snapshotIndices.at(endNode->second) == -1) {
+            pe::Logger::log("Did not find endNode " + loaded.endPointNode + " for startNode " + loaded.id);
             continue;
         }
-
-        if (startNode->hasMovement()) {
-            startNode->_endPointNode = endNode;
-        } else pe::Logger::log("Found endNode for node that didn't have movement: " + pair.first + ", " + pair.second);
+        tree.nodes.at(snapshotIndices.at(i)).movementTarget = snapshotIndices.at(endNode->second);
     }
 
-    _children.clear();
-    _endPoints.clear();
+    return tree;
+}
 
-    if (VisualTree::getNodes().size() == 0) {
-        pe::Logger::log("No nodes were created; attempting to convert file from older version.");
-        load(path, true);
-    }
+void PersistenceImpl::saveBrackets(std::string path) {
+    const auto& nodes = VisualTree::getNodes();
+    if (nodes.empty()) return;
+
+    std::ofstream out(path, std::ios::binary);
+    write(out, BracketNotation::write(TreeSnapshot::capture(nodes.at(0).get())));
+    out.close();
 }
 
-void PersistenceImpl::createNode(std::vector<std::string> lines, bool convertCoordinates) {
-    std::string id = "";
-    sf::Vector2f pos;
-    std::string parent = "";
-    std::vector<std::string> children;
+void PersistenceImpl::createNode(std::vector<std::string> lines) {
+    LoadedNode loaded;
     std::string fieldText = "";
     std::string subscript = "";
-    bool hasMovement = false;
-    std::string endPointNode = "";
-    float curveAngle = 0.f;
-    float curveHeight = 0.f;
-    bool drawTriangle = false;
 
+    // Positions are left out, since the tree is laid out again when it's built
     for (const auto& line : lines) {
         const std::vector tokens = tokenize(line);
         if (tokens.at(1) == ":") {
             const std::string var = tokens.at(0);
-            if (var == "id") id = tokens.at(2);
-            else if (var == "pos") {
-                pos = { std::stof(tokens.at(2)), std::stof(tokens.at(4)) };
-            } else if (var == "parent") parent = tokens.at(2);
+            if (var == "id") loaded.id = tokens.at(2);
+            else if (var == "parent") loaded.parent = tokens.at(2);
             else if (var == "children") {
                 for (int i = 2; i < tokens.size(); i += 2) {
-                    children.push_back(tokens.at(i));
+                    loaded.children.push_back(tokens.at(i));
                 }
             } else if (var == "text") fieldText = tokens.at(2);
             else if (var == "subs") subscript = tokens.at(2);
-            else if (var == "hasMovement") hasMovement = tokens.at(2) == "1";
-            else if (var == "endPointNode") endPointNode = tokens.at(2);
-            else if (var == "curveAngle") curveAngle = std::stof(tokens.at(2));
-            else if (var == "curveHeight") curveHeight = std::stof(tokens.at(2));
-            else if (var == "triangle") drawTriangle = tokens.at(2) == "1";
+            else if (var == "hasMovement") loaded.hasMovement = tokens.at(2) == "1";
+            else if (var == "endPointNode") loaded.endPointNode = tokens.at(2);
+            else if (var == "curveAngle") loaded.node.curveAngle = std::stof(tokens.at(2));
+            else if (var == "curveHeight") loaded.node.curveHeight = std::stof(tokens.at(2));
+            else if (var == "triangle") loaded.node.drawTriangle = tokens.at(2) == "1";
         }
     }
 
     pe::replaceAll(fieldText, "\"", "");
     pe::replaceAll(subscript, "\"", "");
 
-    if (convertCoordinates) {
-        const auto& res = PennyEngine::getRenderResolution();
-        pos.x = pos.x / res.width * 100.f;
-        pos.y = pos.y / res.height * 100.f;
-    }
-
-    s_p<VisualNode> parentNode = nullptr;
-    if (parent != "") parentNode = findNode(parent);
-    const s_p<VisualNode> node = new_s_p(VisualNode, (parentNode.get(), pos.x, pos.y, id));
-
-    node->getText().setString(sf::String::fromUtf8(fieldText.begin(), fieldText.end()));
-    node->_subscript.setString(subscript);
-    node->_hasMovement = hasMovement;
-    node->_curveAngle = curveAngle;
-    node->_curveHeight = curveHeight;
-    node->_drawTriangle = drawTriangle;
-    VisualTree::_instance._nodes.push_back(node);
-    VisualTree::_instance._renderNodes.push_back(node);
-
-    if (children.size() != 0) {
-        _children.push_back({ id, children });
-    }
-
-    if (hasMovement) {
-        _endPoints.push_back({ id, endPointNode });
-    }
-}
-
-s_p<VisualNode> PersistenceImpl::findNode(const std::string id) {
-    for (const auto& node : VisualTree::_instance._nodes) {
-        if (node->getIdentifier() == id) return node;
-    }
+    loaded.node.text = std::make_shared<const sf::String>(sf::String::fromUtf8(fieldText.begin(), fieldText.end()));
+    if (!subscript.empty()) loaded.node.subscript = std::make_shared<const sf::String>(subscript);
 
-    return nullptr;
+    _loadedNodeIndices.emplace(loaded.id, _loadedNodes.size());
+    _loadedNodes.push_back(std::move(loaded));
 }
 
 std::vector<std::string> PersistenceImpl::tokenize(std::string inScript) {
@@ -6,23 +6,42 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "../../PennyEngine/core/Defines.h"
 #include "../visual/VisualNode.h"
+#include "TreeSnapshot.h"
 
 class PersistenceImpl {
 public:
     void save(std::string path);
-    void load(std::string path, bool convert = false);
+    void load(std::string path);
+    // Reads a .treesy file without touching the tree on screen. Returns false if no nodes were read
+    bool read(std::string path, TreeSnapshot& tree, bool convert = false);
+
+    // Labelled bracket notation; see BracketNotation. Bracket files are opened through Corpus
+    void saveBrackets(std::string path);
 private:
     const std::vector<std::string> _operators = { "!=", "==", ">=", "<=", "+", "*", "/", "=", ";", ",", ":", "(", ")", "{", "}", ">", "<", "!", "%" };
     std::vector<std::string> tokenize(std::string inScript);
     std::vector<std::string> splitOperators(std::string bareToken);
 
-    void createNode(std::vector<std::string> lines, bool convertCoordinates);
-    s_p<VisualNode> findNode(const std::string id);
+    struct LoadedNode {
+        std::string id;
+        SnapshotNode node;
+        std::string parent;
+        std::vector<std::string> children;
+        bool hasMovement = false;
+        std::string endPointNode;
+    };
+
+    void createNode(std::vector<std::string> lines);
+    // Puts the nodes read from the file in preorder, which is what VisualTree::build expects
+    TreeSnapshot orderLoadedNodes() const;
 
-    std::vector<std::pair<std::string, std::vector<std::string>>> _children;
-    std::vector<std::pair<std::string, std::string>> _endPoints;
+    // Nodes get fresh ids when they're built, so references in the file are
+    // resolved through the ids the file itself uses (hex ids, or UUIDs in older files)
+    std::vector<LoadedNode> _loadedNodes;
+    std::unordered_map<std::string, size_t> _loadedNodeIndices;
 };
 
 class Persistence {
@@ -35,6 +54,14 @@ public:
         _instance.load(path);
     }
 
+    static bool read(std::string path, TreeSnapshot& tree) {
+        return _instance.read(path, tree);
+    }
+
+    static void saveBrackets(std::string path) {
+        _instance.saveBrackets(path);
+    }
+
 private:
     static inline PersistenceImpl _instance;
 };
@@ -0,0 +1,446 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "PngEncoder.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include "../../PennyEngine/PennyEngine.h"
+#include "../../PennyEngine/core/Logger.h"
+
+constexpr size_t PNG_BYTES_PER_PIXEL = 4;
+
+// Deflate can refer back at most this far
+constexpr size_t DEFLATE_WINDOW_SIZE = 32768;
+constexpr size_t DEFLATE_MIN_MATCH = 3;
+constexpr size_t DEFLATE_MAX_MATCH = 258;
+constexpr unsigned int DEFLATE_HASH_BITS = 15;
+
+constexpr unsigned int NORMAL_MAX_CHAIN_LENGTH = 48;
+constexpr unsigned int FAST_MAX_CHAIN_LENGTH = 1;
+
+constexpr std::array<uint16_t, 29> LENGTH_BASES = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA_BITS = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+constexpr std::array<uint16_t, 30> DISTANCE_BASES = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+constexpr std::array<uint8_t, 30> DISTANCE_EXTRA_BITS = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+constexpr uint32_t ADLER_MODULUS = 65521;
+// The most bytes that can be summed before the 32 bit sums have to be reduced
+constexpr size_t ADLER_BLOCK_SIZE = 5552;
+
+static uint32_t adler32(const uint8_t* data, size_t length) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (length > 0) {
+        const size_t block = std::min(length, ADLER_BLOCK_SIZE);
+        for (size_t i = 0; i < block; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= ADLER_MODULUS;
+        b %= ADLER_MODULUS;
+        data += block;
+        length -= block;
+    }
+    return (b << 16) | a;
+}
+
+// The Adler-32 of two pieces of data put together, from each piece's Adler-32 and the length of the second
+static uint32_t combineAdler32(uint32_t first, uint32_t second, size_t secondLength) {
+    const uint64_t remainder = secondLength % ADLER_MODULUS;
+    const uint64_t a1 = first & 0xFFFF;
+    const uint64_t b1 = first >> 16;
+    const uint64_t a2 = second & 0xFFFF;
+    const uint64_t b2 = second >> 16;
+
+    const uint64_t a = (a1 + a2 + ADLER_MODULUS - 1) % ADLER_MODULUS;
+    const uint64_t b = (remainder * a1 + b1 + b2 + ADLER_MODULUS - remainder) % ADLER_MODULUS;
+    return (uint32_t)((b << 16) | a);
+}
+
+static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+static void appendChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t length) {
+    appendBigEndian(out, (uint32_t)length);
+    const size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + length);
+    appendBigEndian(out, crc32(out.data() + typeStart, length + 4));
+}
+
+class BitWriter {
+public:
+    BitWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+    // Deflate packs values starting from the least significant bit
+    void write(uint32_t bits, unsigned int count) {
+        _buffer |= (uint64_t)bits << _count;
+        _count += count;
+        while (_count >= 8) {
+            _out.push_back((uint8_t)_buffer);
+            _buffer >>= 8;
+            _count -= 8;
+        }
+    }
+
+    void alignToByte() {
+        if (_count > 0) write(0, 8 - _count);
+    }
+private:
+    std::vector<uint8_t>& _out;
+    uint64_t _buffer = 0;
+    unsigned int _count = 0;
+};
+
+struct HuffmanCode {
+    uint16_t bits = 0;
+    uint8_t length = 0;
+};
+
+// Huffman codes start from the most significant bit, unlike everything else in deflate, so they're stored reversed
+static HuffmanCode reversedCode(uint32_t code, uint8_t length) {
+    HuffmanCode reversed;
+    reversed.length = length;
+    for (uint8_t i = 0; i < length; i++) {
+        reversed.bits = (uint16_t)((reversed.bits << 1) | ((code >> i) & 1));
+    }
+    return reversed;
+}
+
+// The fixed literal/length codes from the deflate spec
+static std::array<HuffmanCode, 288> makeSymbolCodes() {
+    std::array<HuffmanCode, 288> codes;
+    for (uint32_t symbol = 0; symbol < codes.size(); symbol++) {
+        if (symbol < 144) codes[symbol] = reversedCode(0x30 + symbol, 8);
+        else if (symbol < 256) codes[symbol] = reversedCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280) codes[symbol] = reversedCode(symbol - 256, 7);
+        else codes[symbol] = reversedCode(0xC0 + symbol - 280, 8);
+    }
+    return codes;
+}
+
+// Index of the length code for every match length
+static std::array<uint8_t, DEFLATE_MAX_MATCH + 1> makeLengthCodes() {
+    std::array<uint8_t, DEFLATE_MAX_MATCH + 1> codes = {};
+    for (size_t length = DEFLATE_MIN_MATCH; length <= DEFLATE_MAX_MATCH; length++) {
+        codes[length] = (uint8_t)(std::upper_bound(LENGTH_BASES.begin(), LENGTH_BASES.end(), length) - LENGTH_BASES.begin() - 1);
+    }
+    return codes;
+}
+
+static const std::array<HuffmanCode, 288> SYMBOL_CODES = makeSymbolCodes();
+static const std::array<uint8_t, DEFLATE_MAX_MATCH + 1> LENGTH_CODES = makeLengthCodes();
+
+static void writeSymbol(BitWriter& writer, unsigned int symbol) {
+    writer.write(SYMBOL_CODES[symbol].bits, SYMBOL_CODES[symbol].length);
+}
+
+static void writeMatch(BitWriter& writer, size_t length, size_t distance) {
+    const uint8_t lengthCode = LENGTH_CODES[length];
+    writeSymbol(writer, 257 + lengthCode);
+    writer.write((uint32_t)(length - LENGTH_BASES[lengthCode]), LENGTH_EXTRA_BITS[lengthCode]);
+
+    // Distance codes are all 5 bits long, so the code is just the index, reversed
+    const size_t distanceCode = std::upper_bound(DISTANCE_BASES.begin(), DISTANCE_BASES.end(), distance) - DISTANCE_BASES.begin() - 1;
+    const HuffmanCode code = reversedCode((uint32_t)distanceCode, 5);
+    writer.write(code.bits, code.length);
+    writer.write((uint32_t)(distance - DISTANCE_BASES[distanceCode]), DISTANCE_EXTRA_BITS[distanceCode]);
+}
+
+static uint32_t hashAt(const uint8_t* data) {
+    const uint32_t bytes = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    return (bytes * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+/*
+    Deflates data[start, end) into out as one fixed Huffman block. data[0, start)
+    is the end of the previous strip, which matches can refer back to but isn't
+    written. Unless this is the last block, an empty stored block follows so the
+    output ends on a byte boundary and the next strip can be appended to it.
+*/
+static void deflateStrip(const std::vector<uint8_t>& data, size_t start, bool lastBlock, unsigned int maxChainLength, std::vector<uint8_t>& out) {
+    const size_t end = data.size();
+    std::vector<int64_t> head((size_t)1 << DEFLATE_HASH_BITS, -1);
+    std::vector<int64_t> previous(DEFLATE_WINDOW_SIZE, -1);
+
+    const auto insert = [&](size_t position) {
+        if (position + DEFLATE_MIN_MATCH > end) return;
+        const uint32_t hash = hashAt(&data[position]);
+        previous[position % DEFLATE_WINDOW_SIZE] = head[hash];
+        head[hash] = (int64_t)position;
+    };
+
+    for (size_t position = 0; position < start; position++) {
+        insert(position);
+    }
+
+    BitWriter writer(out);
+    writer.write(lastBlock ? 1 : 0, 1);
+    writer.write(1, 2);
+
+    size_t position = start;
+    while (position < end) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (position + DEFLATE_MIN_MATCH <= end) {
+            const size_t maxLength = std::min(DEFLATE_MAX_MATCH, end - position);
+            int64_t candidate = head[hashAt(&data[position])];
+            unsigned int chainLength = maxChainLength;
+
+            while (candidate >= 0 && position - (size_t)candidate <= DEFLATE_WINDOW_SIZE && chainLength-- > 0) {
+                const uint8_t* a = &data[(size_t)candidate];
+                const uint8_t* b = &data[position];
+                // Can't beat the best match so far unless it matches one byte further
+                if (a[bestLength] == b[bestLength]) {
+                    size_t length = 0;
+                    while (length < maxLength && a[length] == b[length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = position - (size_t)candidate;
+                        if (length == maxLength) break;
+                    }
+                }
+
+                const int64_t next = previous[(size_t)candidate % DEFLATE_WINDOW_SIZE];
+                // The slot may have been reused by a newer position, which ends the chain
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= DEFLATE_MIN_MATCH) {
+            writeMatch(writer, bestLength, bestDistance);
+            // Fast compression only remembers where matches start, which skips most of the hashing on flat backgrounds
+            const size_t inserted = maxChainLength > FAST_MAX_CHAIN_LENGTH ? bestLength : 1;
+            for (size_t i = 0; i < inserted; i++) {
+                insert(position + i);
+            }
+            position += bestLength;
+        } else {
+            writeSymbol(writer, data[position]);
+            insert(position);
+            position++;
+        }
+    }
+    writeSymbol(writer, 256);
+
+    if (lastBlock) {
+        writer.alignToByte();
+    } else {
+        writer.write(0, 3);
+        writer.alignToByte();
+        writer.write(0x0000, 16);
+        writer.write(0xFFFF, 16);
+    }
+}
+
+enum class PNG_FILTER : uint8_t {
+    NONE,
+    SUB,
+    UP,
+    AVERAGE,
+    PAETH
+};
+
+static uint8_t paethPredictor(int left, int up, int upLeft) {
+    const int estimate = left + up - upLeft;
+    const int toLeft = std::abs(estimate - left);
+    const int toUp = std::abs(estimate - up);
+    const int toUpLeft = std::abs(estimate - upLeft);
+    if (toLeft <= toUp && toLeft <= toUpLeft) return (uint8_t)left;
+    if (toUp <= toUpLeft) return (uint8_t)up;
+    return (uint8_t)upLeft;
+}
+
+// The first pixel of a row has nothing to its left, which counts as 0
+static void filterRow(PNG_FILTER filter, const uint8_t* row, const uint8_t* above, size_t rowBytes, uint8_t* out) {
+    const size_t first = std::min(PNG_BYTES_PER_PIXEL, rowBytes);
+    switch (filter) {
+        case PNG_FILTER::NONE:
+            std::copy(row, row + rowBytes, out);
+            break;
+        case PNG_FILTER::SUB:
+            std::copy(row, row + first, out);
+            for (size_t i = first; i < rowBytes; i++) out[i] = row[i] - row[i - PNG_BYTES_PER_PIXEL];
+            break;
+        case PNG_FILTER::UP:
+            for (size_t i = 0; i < rowBytes; i++) out[i] = row[i] - above[i];
+            break;
+        case PNG_FILTER::AVERAGE:
+            for (size_t i = 0; i < first; i++) out[i] = row[i] - above[i] / 2;
+            for (size_t i = first; i < rowBytes; i++) out[i] = row[i] - (uint8_t)((row[i - PNG_BYTES_PER_PIXEL] + above[i]) / 2);
+            break;
+        case PNG_FILTER::PAETH:
+            for (size_t i = 0; i < first; i++) out[i] = row[i] - above[i];
+            for (size_t i = first; i < rowBytes; i++) {
+                out[i] = row[i] - paethPredictor(row[i - PNG_BYTES_PER_PIXEL], above[i], above[i - PNG_BYTES_PER_PIXEL]);
+            }
+            break;
+    }
+}
+
+// Each row is written as a filter type followed by the filtered bytes
+static void filterRows(const uint8_t* pixels, size_t rowBytes, size_t firstRow, size_t lastRow, PNG_COMPRESSION compression,
+    std::vector<uint8_t>& out) {
+    const std::vector<uint8_t> emptyRow(rowBytes, 0);
+    std::vector<uint8_t> candidate(rowBytes);
+
+    for (size_t y = firstRow; y < lastRow; y++) {
+        const uint8_t* row = pixels + y * rowBytes;
+        const uint8_t* above = y > 0 ? row - rowBytes : emptyRow.data();
+
+        const size_t rowStart = out.size();
+        out.resize(rowStart + 1 + rowBytes);
+
+        if (compression == PNG_COMPRESSION::FAST) {
+            out[rowStart] = (uint8_t)PNG_FILTER::SUB;
+            filterRow(PNG_FILTER::SUB, row, above, rowBytes, &out[rowStart + 1]);
+            continue;
+        }
+
+        // Keeps whichever filter leaves the smallest values, counting bytes as signed
+        uint64_t bestScore = UINT64_MAX;
+        for (uint8_t filter = (uint8_t)PNG_FILTER::NONE; filter <= (uint8_t)PNG_FILTER::PAETH; filter++) {
+            filterRow((PNG_FILTER)filter, row, above, rowBytes, candidate.data());
+
+            uint64_t score = 0;
+            for (size_t i = 0; i < rowBytes; i++) {
+                score += std::abs((int)(int8_t)candidate[i]);
+            }
+            if (score < bestScore) {
+                bestScore = score;
+                out[rowStart] = filter;
+                std::copy(candidate.begin(), candidate.end(), out.begin() + rowStart + 1);
+            }
+        }
+    }
+}
+
+struct EncodedStrip {
+    std::vector<uint8_t> deflated;
+    uint32_t adler = 1;
+    size_t filteredBytes = 0;
+};
+
+static EncodedStrip encodeStrip(const uint8_t* pixels, size_t rowBytes, size_t firstRow, size_t lastRow, bool lastStrip,
+    PNG_COMPRESSION compression) {
+    const size_t filteredRowBytes = rowBytes + 1;
+    // The rows above the strip that the deflate window can reach, filtered again so matches can refer back to them
+    const size_t primingRows = std::min(firstRow, (DEFLATE_WINDOW_SIZE + filteredRowBytes - 1) / filteredRowBytes);
+
+    std::vector<uint8_t> filtered;
+    filtered.reserve((lastRow - firstRow + primingRows) * filteredRowBytes);
+    filterRows(pixels, rowBytes, firstRow - primingRows, lastRow, compression, filtered);
+
+    const size_t start = primingRows * filteredRowBytes;
+
+    EncodedStrip strip;
+    strip.filteredBytes = filtered.size() - start;
+    strip.adler = adler32(filtered.data() + start, strip.filteredBytes);
+    strip.deflated.reserve(strip.filteredBytes / 4);
+    deflateStrip(filtered, start, lastStrip,
+        compression == PNG_COMPRESSION::FAST ? FAST_MAX_CHAIN_LENGTH : NORMAL_MAX_CHAIN_LENGTH, strip.deflated);
+    return strip;
+}
+
+std::vector<sf::Uint8> PngEncoder::encode(const sf::Image& image, PNG_COMPRESSION compression) {
+    const sf::Vector2u size = image.getSize();
+    const uint8_t* pixels = image.getPixelsPtr();
+    const size_t rowBytes = (size_t)size.x * PNG_BYTES_PER_PIXEL;
+
+    if (size.x == 0 || size.y == 0) return {};
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    std::vector<uint8_t> header;
+    appendBigEndian(header, size.x);
+    appendBigEndian(header, size.y);
+    // 8 bits per channel, RGBA, deflate, standard filtering, not interlaced
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });
+    appendChunk(png, "IHDR", header.data(), header.size());
+
+    auto& scheduler = PennyEngine::getTaskScheduler();
+    const size_t threadCount = std::max(1u, scheduler.getThreadCount());
+    const size_t minStripRows = (PNG_MIN_STRIP_BYTES + rowBytes - 1) / rowBytes;
+    const size_t stripRows = std::max(minStripRows, (size.y + threadCount * PNG_STRIPS_PER_THREAD - 1) / (threadCount * PNG_STRIPS_PER_THREAD));
+
+    std::vector<std::future<EncodedStrip>> strips;
+    for (size_t firstRow = 0; firstRow < size.y; firstRow += stripRows) {
+        const size_t lastRow = std::min<size_t>(size.y, firstRow + stripRows);
+        const bool lastStrip = lastRow == size.y;
+        strips.push_back(scheduler.submit([=]() {
+            return encodeStrip(pixels, rowBytes, firstRow, lastRow, lastStrip, compression);
+        }));
+    }
+
+    // Each strip goes in its own IDAT chunk, which decoders read as one stream
+    const uint8_t zlibHeader[] = { 0x78, (uint8_t)(compression == PNG_COMPRESSION::FAST ? 0x01 : 0x9C) };
+    appendChunk(png, "IDAT", zlibHeader, sizeof(zlibHeader));
+
+    uint32_t adler = 1;
+    for (auto& future : strips) {
+        const EncodedStrip strip = future.get();
+        adler = combineAdler32(adler, strip.adler, strip.filteredBytes);
+        appendChunk(png, "IDAT", strip.deflated.data(), strip.deflated.size());
+    }
+
+    std::vector<uint8_t> trailer;
+    appendBigEndian(trailer, adler);
+    appendChunk(png, "IDAT", trailer.data(), trailer.size());
+    appendChunk(png, "IEND", nullptr, 0);
+
+    return png;
+}
+
+bool PngEncoder::save(const sf::Image& image, const std::string& path, PNG_COMPRESSION compression) {
+    const std::vector<sf::Uint8> png = encode(image, compression);
+    if (png.empty()) {
+        pe::Logger::log("Can't save an empty image: " + path);
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*)png.data(), png.size());
+    out.close();
+    return out.good();
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _PNG_ENCODER_H
+#define _PNG_ENCODER_H
+
+#include <string>
+#include <vector>
+#include <SFML/Graphics/Image.hpp>
+
+// Strips are at least this many bytes of image data, so small images aren't split into strips too short to compress well
+constexpr size_t PNG_MIN_STRIP_BYTES = 256 * 1024;
+// Each strip is split again for every worker thread so a slow strip doesn't hold up the rest
+constexpr unsigned int PNG_STRIPS_PER_THREAD = 2;
+
+enum class PNG_COMPRESSION {
+    // Picks a filter for every row and searches further back for matches
+    NORMAL,
+    // For drafts: about as fast as encoding can go, at the cost of larger files
+    FAST
+};
+
+/*
+    Writes RGBA PNGs, compressing horizontal strips of the image in
+    parallel on the task scheduler.
+
+    Every strip is filtered and deflated on its own, into a run of
+    deflate blocks that ends on a byte boundary, so the strips can be
+    concatenated into one zlib stream. Each strip is primed with the
+    end of the strip above it, so matches can still reach across the
+    boundary, and the strips' checksums are combined for the stream's
+    trailer. Blocks use the fixed Huffman codes.
+*/
+class PngEncoder {
+public:
+    static bool save(const sf::Image& image, const std::string& path, PNG_COMPRESSION compression = PNG_COMPRESSION::NORMAL);
+
+    static std::vector<sf::Uint8> encode(const sf::Image& image, PNG_COMPRESSION compression = PNG_COMPRESSION::NORMAL);
+};
+
+#endif
\ No newline at end of file
@@ -10,16 +10,37 @@
 #include "Settings.h"
 #include "../visual/Line.h"
 #include "Versioning.h"
+#include "History.h"
+#include "Clipboard.h"
+#include "Corpus.h"
+#include "LabelIndex.h"
+#include "TreeDiff.h"
+#include "Persistence.h"
+#include <cmath>
 
 ProgramManager::ProgramManager() {
     PennyEngine::addInputListener(this);
 }
 
+void ProgramManager::openOnStartup(const std::string& path) {
+    _startupPath = path;
+    if (pe::stringEndsWith(path, ".treesy")) {
+        PennyEngine::addStartupTask([this]() { Persistence::read(_startupPath, _startupTree); });
+    }
+}
+
 void ProgramManager::init() {
-    VisualTree::addChild(nullptr);
+    if (_startupTree.nodes.empty()) VisualTree::addChild(nullptr);
+    else VisualTree::build(_startupTree);
+    _startupTree.nodes.clear();
 
     UIHandler::init();
 
+    // Bracketed files go through the corpus browser, the same as Open tree
+    if (!_startupPath.empty() && !pe::stringEndsWith(_startupPath, ".treesy")) {
+        if (Corpus::open(_startupPath) && Corpus::getTreeCount() > 1) pe::UI::getMenu("corpus")->open();
+    }
+
     _versionLabel.setFont(PennyEngine::getFont());
     _versionLabel.setString("v" + VERSION + " (" + BUILD_NUMBER + ")");
     _versionLabel.setCharacterSize(pe::UI::percentToScreenWidth(1.f));
@@ -28,7 +49,9 @@ void ProgramManager::init() {
 }
 
 void ProgramManager::update() {
+    Corpus::update();
     VisualTree::update();
+    LabelIndex::update();
 }
 
 void ProgramManager::draw(sf::RenderTexture& surface) {
@@ -64,51 +87,79 @@ void ProgramManager::sliderMoved(std::string sliderId, float value) {
 void ProgramManager::keyPressed(sf::Keyboard::Key& key) {
 }
 
+static VisualNode* findNode(bool armed) {
+    for (const auto& node : VisualTree::getNodes()) {
+        if (node->isActive() && !node->isHiddenByCollapse() && (armed ? node->isArmed() : node->isHovered())) return node.get();
+    }
+    return nullptr;
+}
+
 void ProgramManager::keyReleased(sf::Keyboard::Key& key) {
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::V) {
-        for (const auto& node : VisualTree::getNodes()) {
-            if (node->isActive() && node->isArmed()) {
-                node->getText().setString(node->getText().getString() + sf::Clipboard::getString());
-                break;
-            }
+    // While a node's text is being edited these work on its text, otherwise on the subtree under the mouse
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && (key == sf::Keyboard::C || key == sf::Keyboard::X || key == sf::Keyboard::V)) {
+        VisualNode* armedNode = findNode(true);
+        VisualNode* hoveredNode = armedNode == nullptr ? findNode(false) : nullptr;
+
+        if (key == sf::Keyboard::V && armedNode != nullptr) {
+            const sf::String before = armedNode->getText().getString();
+            armedNode->getText().setString(before + sf::Clipboard::getString());
+            History::recordTextChange(armedNode, before);
+        } else if (key == sf::Keyboard::C && armedNode != nullptr) {
+            sf::Clipboard::setString(armedNode->getText().getString());
+        } else if (hoveredNode != nullptr) {
+            if (key == sf::Keyboard::C) Clipboard::copy(hoveredNode);
+            else if (key == sf::Keyboard::X) Clipboard::cut(hoveredNode);
+            else if (key == sf::Keyboard::V) Clipboard::paste(hoveredNode);
         }
     }
 
-    if (key == sf::Keyboard::F3) _showDebug = !_showDebug;
-}
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::Space) {
+        VisualNode* hoveredNode = findNode(true) == nullptr ? findNode(false) : nullptr;
+        if (hoveredNode != nullptr) hoveredNode->setCollapsed(!hoveredNode->isCollapsed());
+    }
 
-static sf::Vector2f mapMouseCoordinates(const int mx, const int my) {
-    const sf::Vector2i mouseCoords(mx, my);
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::Z) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) History::redo();
+        else History::undo();
+    } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::Y) {
+        History::redo();
+    }
 
-    return PennyEngine::getWindow().mapPixelToCoords(mouseCoords, PennyEngine::getCamera());
-}
+    if (Corpus::isOpen()) {
+        if (key == sf::Keyboard::PageDown) Corpus::next();
+        else if (key == sf::Keyboard::PageUp) Corpus::previous();
+    }
 
-void ProgramManager::mouseButtonPressed(const int mx, const int my, const int button) {
-    for (const auto& node : VisualTree::getNodes()) {
-        if (node->isActive() && node->getBounds().contains(mapMouseCoordinates(mx, my))) {
-            _clickedIntoNode = true;
-            return;
-        }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::F) {
+        pe::UI::getMenu("search")->open();
     }
 
-    for (const auto& menu : pe::UI::getMenus()) {
-        if (menu->isActive()) {
-            for (const auto& component : menu->getComponents()) {
-                if (component->isActive() && component->getBounds().contains(mx, my)) {
-                    _clickedIntoNode = true;
-                    return;
-                }
-            }
-        }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::D) {
+        // The same keys close it again and put the original tree back
+        if (TreeDiff::isShowingComparison()) TreeDiff::closeComparison();
+        else TreeDiff::showComparison(UIHandler::getLoadPath());
     }
+
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) && key == sf::Keyboard::M) {
+        const auto& minimap = pe::UI::getMenu("minimap");
+        if (minimap->isActive()) minimap->close();
+        else minimap->open();
+    }
+
+    if (key == sf::Keyboard::F3) _showDebug = !_showDebug;
+}
+
+void ProgramManager::mouseButtonPressed(const int mx, const int my, const int button) {
+    // Menus and nodes consume presses that land on them, so this only hears clicks on the background
+    _panning = true;
 }
 
 void ProgramManager::mouseButtonReleased(const int mx, const int my, const int button) {
-    _clickedIntoNode = false;
+    _panning = false;
 }
 
 void ProgramManager::mouseMoved(const int mx, const int my) {
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Left) && !_clickedIntoNode) {
+    if (sf::Mouse::isButtonPressed(sf::Mouse::Left) && _panning) {
         const sf::Vector2f viewSize = PennyEngine::getCamera().getSize();
         const sf::Vector2f res((float)PennyEngine::getRenderResolution().width, (float)PennyEngine::getRenderResolution().height);
         const sf::Vector2f scale = { viewSize.x / res.x, viewSize.y / res.y };
@@ -119,16 +170,12 @@ void ProgramManager::mouseMoved(const int mx, const int my) {
         PennyEngine::getCamera().move(delta.x * scale.x, delta.y * scale.y);
     }
 
-    if (!_clickedIntoNode) _clickPos = { mx, my };
+    _clickPos = { mx, my };
 }
 
 void ProgramManager::mouseWheelScrolled(sf::Event::MouseWheelScrollEvent mouseWheelScroll) {
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::LAlt)) {
-        for (const auto& node : VisualTree::getNodes()) {
-            if (node->isActive() && node->isSelectingMovement()) return;
-        }
-    }
-
-    const float factor = (1.f / ((mouseWheelScroll.delta * 8.f + 100.f) / 100.f));
+    // Scrolls over menus or that adjust a movement line are consumed before they get here.
+    // Scrolls from the same frame arrive summed, so each notch zooms by the same factor
+    const float factor = std::pow(1.f / 1.08f, mouseWheelScroll.delta);
     PennyEngine::getCamera().zoom(factor);
 }
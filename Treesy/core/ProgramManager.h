@@ -7,11 +7,15 @@
 #include "../../PennyEngine/core/GameManager.h"
 #include "../../PennyEngine/input/KeyListener.h"
 #include "../../PennyEngine/input/MouseListener.h"
+#include "TreeSnapshot.h"
 
 class ProgramManager : public pe::GameManager, public pe::MouseListener, public pe::KeyListener {
 public:
     ProgramManager();
 
+    // Call before the engine starts. .treesy files are read while the window opens
+    void openOnStartup(const std::string& path);
+
     virtual void init();
 
     virtual void update();
@@ -32,7 +36,11 @@ protected:
     virtual void onShutdown();
 private:
     sf::Vector2i _clickPos;
-    bool _clickedIntoNode = false;
+    // Set when a press wasn't taken by a menu or node, so dragging moves the camera
+    bool _panning = false;
+
+    std::string _startupPath;
+    TreeSnapshot _startupTree;
 
     bool _showDebug = false;
     sf::Text _versionLabel;
@@ -28,6 +28,9 @@ public:
 
     static inline float horzSpacing = 0.f;
 
+    // PNG exports compress faster but come out larger
+    static inline bool draftExports = false;
+
     static void save() {
         const std::string localLowPath = pe::getLocalLowPath() + "\\jsell\\Treesy\\";
         if (!std::filesystem::is_directory(localLowPath)) {
@@ -42,6 +45,7 @@ public:
             out << "termColor=" << std::to_string(termColor.toInteger()) << std::endl;
             out << "showTermLines=" << std::to_string(showTermLines) << std::endl;
             out << "horzSpacing=" << std::to_string(horzSpacing) << std::endl;
+            out << "draftExports=" << std::to_string(draftExports) << std::endl;
         } catch (std::exception ex) {
             pe::Logger::log(ex.what());
         }
@@ -60,6 +64,7 @@ public:
                 else if (parsedLine[0] == "termColor") termColor = sf::Color(std::stoul(parsedLine[1]));
                 else if (parsedLine[0] == "showTermLines") showTermLines = parsedLine[1] == "1";
                 else if (parsedLine[0] == "horzSpacing") horzSpacing = std::stof(parsedLine[1]);
+                else if (parsedLine[0] == "draftExports") draftExports = parsedLine[1] == "1";
             }
         } else {
             pe::Logger::log("Did not find settings.ini");
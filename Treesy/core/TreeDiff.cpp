@@ -0,0 +1,363 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "TreeDiff.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include "BracketNotation.h"
+#include "Persistence.h"
+#include "History.h"
+#include "Corpus.h"
+#include "../visual/VisualTree.h"
+#include "../../PennyEngine/ui/UI.h"
+#include "../../PennyEngine/core/Logger.h"
+#include "../../PennyEngine/core/Util.h"
+
+static std::string toUtf8(const sf::String& text) {
+    const auto utf8 = text.toUtf8();
+    return std::string(utf8.begin(), utf8.end());
+}
+
+static uint64_t hashString(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : text) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void combineHash(uint64_t& hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+}
+
+std::string TreeDiffImpl::getLabel(const SnapshotNode& node) {
+    std::string label = toUtf8(*node.text);
+    if (node.subscript != nullptr) label += "_" + toUtf8(*node.subscript);
+    return label;
+}
+
+TreeDiffImpl::TreeInfo TreeDiffImpl::analyze(const TreeSnapshot& tree) {
+    const size_t count = tree.nodes.size();
+
+    TreeInfo info;
+    info.labels.reserve(count);
+    info.children.resize(count);
+    info.sizes.assign(count, 1);
+    info.hashes.assign(count, 0);
+
+    for (size_t i = 0; i < count; i++) {
+        const auto& node = tree.nodes.at(i);
+        // Kept apart from the text with a character labels can't contain, so "NP_i" and NP with subscript i differ
+        std::string label = toUtf8(*node.text);
+        if (node.subscript != nullptr) label += '\x1F' + toUtf8(*node.subscript);
+        info.labels.push_back(std::move(label));
+
+        if (node.parent == -1) info.roots.push_back((int)i);
+        else info.children.at(node.parent).push_back((int)i);
+    }
+
+    // Preorder, so walking backwards reaches every child before its parent
+    for (size_t i = count; i-- > 0;) {
+        uint64_t hash = hashString(info.labels.at(i));
+        combineHash(hash, info.children.at(i).size());
+        for (const int child : info.children.at(i)) {
+            info.sizes.at(i) += info.sizes.at(child);
+            combineHash(hash, info.hashes.at(child));
+        }
+        info.hashes.at(i) = hash;
+    }
+
+    return info;
+}
+
+unsigned int TreeDiffImpl::getPairCost(const TreeInfo& before, int a, const TreeInfo& after, int b) {
+    if (before.hashes.at(a) == after.hashes.at(b)) return 0;
+
+    const unsigned int sizeA = before.sizes.at(a);
+    const unsigned int sizeB = after.sizes.at(b);
+    const unsigned int sizeDifference = sizeA > sizeB ? sizeA - sizeB : sizeB - sizeA;
+    return (before.labels.at(a) == after.labels.at(b) ? 1 : 2) + sizeDifference;
+}
+
+std::vector<TreeDiffImpl::AlignedChild> TreeDiffImpl::alignChildren(const TreeInfo& before, const std::vector<int>& a, const TreeInfo& after, const std::vector<int>& b) {
+    std::vector<AlignedChild> aligned;
+    aligned.reserve(std::max(a.size(), b.size()));
+
+    // Children that are the same at either end are paired without aligning the rest
+    size_t start = 0;
+    while (start < a.size() && start < b.size() && before.hashes.at(a.at(start)) == after.hashes.at(b.at(start))) start++;
+    size_t endA = a.size();
+    size_t endB = b.size();
+    while (endA > start && endB > start && before.hashes.at(a.at(endA - 1)) == after.hashes.at(b.at(endB - 1))) {
+        endA--;
+        endB--;
+    }
+
+    for (size_t i = 0; i < start; i++) aligned.push_back({ DIFF_TYPE::KEEP, a.at(i), b.at(i) });
+
+    const size_t m = endA - start;
+    const size_t n = endB - start;
+    if ((m + 1) * (n + 1) > DIFF_MAX_ALIGNMENT_CELLS) {
+        for (size_t i = 0; i < std::max(m, n); i++) {
+            if (i < m && i < n) aligned.push_back({ DIFF_TYPE::KEEP, a.at(start + i), b.at(start + i) });
+            else if (i < m) aligned.push_back({ DIFF_TYPE::DELETE, a.at(start + i), -1 });
+            else aligned.push_back({ DIFF_TYPE::INSERT, -1, b.at(start + i) });
+        }
+    } else if (m > 0 || n > 0) {
+        // costs[i * (n + 1) + j] is the cheapest way to turn the first i children of a into the first j of b
+        const size_t width = n + 1;
+        std::vector<unsigned int> costs((m + 1) * width, 0);
+        for (size_t i = 1; i <= m; i++) costs.at(i * width) = costs.at((i - 1) * width) + before.sizes.at(a.at(start + i - 1));
+        for (size_t j = 1; j <= n; j++) costs.at(j) = costs.at(j - 1) + after.sizes.at(b.at(start + j - 1));
+
+        for (size_t i = 1; i <= m; i++) {
+            const int childA = a.at(start + i - 1);
+            for (size_t j = 1; j <= n; j++) {
+                const int childB = b.at(start + j - 1);
+                const unsigned int pair = costs.at((i - 1) * width + j - 1) + getPairCost(before, childA, after, childB);
+                const unsigned int remove = costs.at((i - 1) * width + j) + before.sizes.at(childA);
+                const unsigned int insert = costs.at(i * width + j - 1) + after.sizes.at(childB);
+                costs.at(i * width + j) = std::min({ pair, remove, insert });
+            }
+        }
+
+        std::vector<AlignedChild> middle;
+        size_t i = m;
+        size_t j = n;
+        while (i > 0 || j > 0) {
+            const unsigned int cost = costs.at(i * width + j);
+            if (i > 0 && j > 0
+                && cost == costs.at((i - 1) * width + j - 1) + getPairCost(before, a.at(start + i - 1), after, b.at(start + j - 1))) {
+                middle.push_back({ DIFF_TYPE::KEEP, a.at(start + i - 1), b.at(start + j - 1) });
+                i--;
+                j--;
+            } else if (j > 0 && (i == 0 || cost == costs.at(i * width + j - 1) + after.sizes.at(b.at(start + j - 1)))) {
+                middle.push_back({ DIFF_TYPE::INSERT, -1, b.at(start + j - 1) });
+                j--;
+            } else {
+                middle.push_back({ DIFF_TYPE::DELETE, a.at(start + i - 1), -1 });
+                i--;
+            }
+        }
+        aligned.insert(aligned.end(), middle.rbegin(), middle.rend());
+    }
+
+    for (size_t i = 0; i < a.size() - endA; i++) aligned.push_back({ DIFF_TYPE::KEEP, a.at(endA + i), b.at(endB + i) });
+
+    return aligned;
+}
+
+bool TreeDiffResult::isIdentical() const {
+    return relabelled == 0 && inserted == 0 && deleted == 0;
+}
+
+float TreeDiffResult::getSimilarity() const {
+    if (beforeCount + afterCount == 0) return 1.f;
+    return 2.f * kept / (float)(beforeCount + afterCount);
+}
+
+TreeDiffResult TreeDiffImpl::compare(const TreeSnapshot& before, const TreeSnapshot& after) const {
+    const TreeInfo beforeInfo = analyze(before);
+    const TreeInfo afterInfo = analyze(after);
+
+    TreeDiffResult result;
+    result.beforeCount = (unsigned int)before.nodes.size();
+    result.afterCount = (unsigned int)after.nodes.size();
+    result.entries.reserve(before.nodes.size() + after.nodes.size());
+
+    // Worked through with a stack rather than recursion, since trees can be thousands of levels deep.
+    // Children are pushed in reverse so the entries come out in preorder
+    std::vector<DiffEntry> stack;
+    const auto pushChildren = [&stack](const std::vector<AlignedChild>& children, int parent) {
+        for (auto it = children.rbegin(); it != children.rend(); it++) {
+            stack.push_back({ it->type, it->before, it->after, parent });
+        }
+    };
+    pushChildren(alignChildren(beforeInfo, beforeInfo.roots, afterInfo, afterInfo.roots), -1);
+
+    while (!stack.empty()) {
+        DiffEntry entry = stack.back();
+        stack.pop_back();
+
+        const int index = (int)result.entries.size();
+        if (entry.type == DIFF_TYPE::KEEP) {
+            if (beforeInfo.labels.at(entry.before) != afterInfo.labels.at(entry.after)) {
+                entry.type = DIFF_TYPE::RELABEL;
+                result.relabelled++;
+            } else result.kept++;
+
+            pushChildren(alignChildren(beforeInfo, beforeInfo.children.at(entry.before), afterInfo, afterInfo.children.at(entry.after)), index);
+        } else if (entry.type == DIFF_TYPE::DELETE) {
+            result.deleted++;
+            const auto& children = beforeInfo.children.at(entry.before);
+            for (auto it = children.rbegin(); it != children.rend(); it++) stack.push_back({ DIFF_TYPE::DELETE, *it, -1, index });
+        } else {
+            result.inserted++;
+            const auto& children = afterInfo.children.at(entry.after);
+            for (auto it = children.rbegin(); it != children.rend(); it++) stack.push_back({ DIFF_TYPE::INSERT, -1, *it, index });
+        }
+        result.entries.push_back(entry);
+    }
+
+    // Labels come from the newer tree wherever a node is in both
+    std::vector<int> afterIndices(after.nodes.size(), -1);
+    result.merged.nodes.reserve(result.entries.size());
+    for (size_t i = 0; i < result.entries.size(); i++) {
+        const auto& entry = result.entries.at(i);
+        const SnapshotNode& source = entry.after != -1 ? after.nodes.at(entry.after) : before.nodes.at(entry.before);
+        result.merged.addNode(entry.parent, source.text, source.subscript, source.drawTriangle);
+        if (entry.after != -1) afterIndices.at(entry.after) = (int)i;
+    }
+
+    // Only the newer tree's movement lines are kept, since every one of its nodes is in the merged tree
+    for (size_t i = 0; i < result.entries.size(); i++) {
+        const int afterIndex = result.entries.at(i).after;
+        if (afterIndex == -1 || after.nodes.at(afterIndex).movementTarget == -1) continue;
+
+        const auto& source = after.nodes.at(afterIndex);
+        auto& node = result.merged.nodes.at(i);
+        node.movementTarget = afterIndices.at(source.movementTarget);
+        node.curveAngle = source.curveAngle;
+        node.curveHeight = source.curveHeight;
+    }
+
+    return result;
+}
+
+std::string TreeDiffImpl::report(const TreeDiffResult& diff, const TreeSnapshot& before, const TreeSnapshot& after,
+    const std::string& beforeName, const std::string& afterName) const {
+    const auto& entries = diff.entries;
+
+    std::vector<unsigned int> sizes(entries.size(), 1);
+    for (size_t i = entries.size(); i-- > 0;) {
+        if (entries.at(i).parent != -1) sizes.at(entries.at(i).parent) += sizes.at(i);
+    }
+
+    std::ostringstream out;
+    out << "Before: " << beforeName << " (" << diff.beforeCount << " nodes)\n";
+    out << "After: " << afterName << " (" << diff.afterCount << " nodes)\n";
+    out << "Kept " << diff.kept << ", relabelled " << diff.relabelled << ", inserted " << diff.inserted << ", deleted " << diff.deleted << "\n";
+    out << "Similarity: " << std::fixed << std::setprecision(1) << diff.getSimilarity() * 100.f << "%\n";
+    if (diff.isIdentical()) return out.str();
+
+    // Nodes are located by their position in preorder in each file, counting the root as 1
+    out << "\n";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const auto& entry = entries.at(i);
+        if (entry.type == DIFF_TYPE::KEEP) continue;
+        // Everything under an inserted or deleted node is too, so only the top of the subtree is listed
+        if (entry.type != DIFF_TYPE::RELABEL && entry.parent != -1 && entries.at(entry.parent).type == entry.type) continue;
+
+        if (entry.type == DIFF_TYPE::RELABEL) {
+            out << "relabel  \"" << getLabel(before.nodes.at(entry.before)) << "\" -> \"" << getLabel(after.nodes.at(entry.after))
+                << "\" at before #" << entry.before + 1 << ", after #" << entry.after + 1;
+        } else if (entry.type == DIFF_TYPE::DELETE) {
+            out << "delete   \"" << getLabel(before.nodes.at(entry.before)) << "\" (" << sizes.at(i) << (sizes.at(i) == 1 ? " node" : " nodes")
+                << ") at before #" << entry.before + 1;
+        } else {
+            out << "insert   \"" << getLabel(after.nodes.at(entry.after)) << "\" (" << sizes.at(i) << (sizes.at(i) == 1 ? " node" : " nodes")
+                << ") at after #" << entry.after + 1;
+        }
+        if (entry.parent != -1) out << ", under \"" << getLabel(diff.merged.nodes.at(entry.parent)) << "\"";
+        out << "\n";
+    }
+
+    return out.str();
+}
+
+bool TreeDiffImpl::readFile(const std::string& path, TreeSnapshot& tree) const {
+    if (pe::stringEndsWith(path, ".treesy")) return Persistence::read(path, tree);
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) return false;
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    return BracketNotation::read(text, tree);
+}
+
+bool TreeDiffImpl::showComparison(const std::string& path) {
+    const auto& nodes = VisualTree::getNodes();
+    if (nodes.empty() || path.empty()) return false;
+
+    TreeSnapshot after;
+    if (!readFile(path, after)) {
+        pe::Logger::log("Could not read a tree from " + path);
+        return false;
+    }
+
+    // Comparing again while a comparison is open compares against the original tree, not the merge
+    if (!_showingComparison) _beforeComparison = TreeSnapshot::capture(nodes.at(0).get());
+    const TreeSnapshot& before = _beforeComparison;
+    const TreeDiffResult diff = compare(before, after);
+    pe::Logger::log(report(diff, before, after, "current tree", path));
+
+    Corpus::close();
+    pe::UI::getMenu("corpus")->close();
+    VisualTree::reset();
+    History::clear();
+    VisualTree::build(diff.merged);
+
+    // build() leaves the nodes in the same order as the snapshot
+    const auto& merged = VisualTree::getNodes();
+    for (size_t i = 0; i < merged.size() && i < diff.entries.size(); i++) {
+        const DIFF_TYPE type = diff.entries.at(i).type;
+        if (type == DIFF_TYPE::INSERT) merged.at(i)->setOverlayColor(DIFF_INSERTED_COLOR);
+        else if (type == DIFF_TYPE::DELETE) merged.at(i)->setOverlayColor(DIFF_DELETED_COLOR);
+        else if (type == DIFF_TYPE::RELABEL) merged.at(i)->setOverlayColor(DIFF_RELABELLED_COLOR);
+    }
+
+    _showingComparison = true;
+    return true;
+}
+
+void TreeDiffImpl::closeComparison(bool restoreTree) {
+    if (!_showingComparison) return;
+    _showingComparison = false;
+
+    if (restoreTree) {
+        VisualTree::reset();
+        History::clear();
+        VisualTree::build(_beforeComparison);
+    }
+    _beforeComparison.nodes.clear();
+}
+
+bool TreeDiffImpl::isShowingComparison() const {
+    return _showingComparison;
+}
+
+int TreeDiffImpl::runCommandLine(const std::string& beforePath, const std::string& afterPath, const std::string& reportPath) const {
+    TreeSnapshot before;
+    if (!readFile(beforePath, before)) {
+        std::cerr << "Could not read a tree from " << beforePath << std::endl;
+        return 2;
+    }
+
+    TreeSnapshot after;
+    if (!readFile(afterPath, after)) {
+        std::cerr << "Could not read a tree from " << afterPath << std::endl;
+        return 2;
+    }
+
+    const TreeDiffResult diff = compare(before, after);
+    const std::string text = report(diff, before, after, beforePath, afterPath);
+
+    if (reportPath.empty()) std::cout << text;
+    else {
+        std::ofstream out(reportPath, std::ios::binary);
+        if (!out.good()) {
+            std::cerr << "Could not write " << reportPath << std::endl;
+            return 2;
+        }
+        out << text;
+        out.close();
+    }
+
+    return diff.isIdentical() ? 0 : 1;
+}
\ No newline at end of file
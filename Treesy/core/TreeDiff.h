@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _TREE_DIFF_H
+#define _TREE_DIFF_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics/Color.hpp>
+#include "TreeSnapshot.h"
+
+// Above this many cells, two lists of children are paired up by position instead of aligned
+constexpr size_t DIFF_MAX_ALIGNMENT_CELLS = 4000000;
+
+const sf::Color DIFF_INSERTED_COLOR(0, 200, 80, 110);
+const sf::Color DIFF_DELETED_COLOR(230, 40, 40, 110);
+const sf::Color DIFF_RELABELLED_COLOR(150, 80, 230, 110);
+
+enum class DIFF_TYPE {
+    KEEP,
+    RELABEL,
+    INSERT,
+    DELETE
+};
+
+struct DiffEntry {
+    DIFF_TYPE type = DIFF_TYPE::KEEP;
+    // Index of the node in each tree, or -1 if it isn't in that tree
+    int before = -1;
+    int after = -1;
+    // Index of the parent in TreeDiffResult::entries, or -1 for a root
+    int parent = -1;
+};
+
+struct TreeDiffResult {
+    // Both trees merged together in preorder. entries[i] is merged.nodes[i]
+    std::vector<DiffEntry> entries;
+    TreeSnapshot merged;
+
+    unsigned int beforeCount = 0;
+    unsigned int afterCount = 0;
+    unsigned int kept = 0;
+    unsigned int relabelled = 0;
+    unsigned int inserted = 0;
+    unsigned int deleted = 0;
+
+    bool isIdentical() const;
+    // Share of nodes kept with the same label, from 0 to 1
+    float getSimilarity() const;
+};
+
+/*
+    Compares two trees and lists the edits that turn one into the other.
+
+    A node is kept, relabelled (its label or subscript changed), inserted
+    or deleted. Labels, subscripts and structure are compared; layout,
+    triangles and movement lines aren't.
+
+    This is a top-down diff rather than a minimal tree edit distance:
+    roots are paired, then each pair's children are aligned in order,
+    cheapest first, using subtree hashes and sizes to estimate the cost
+    of pairing two children. Identical runs at either end are matched
+    without aligning. Edits that move a subtree to a different parent
+    show up as a deletion and an insertion.
+*/
+class TreeDiffImpl {
+public:
+    TreeDiffResult compare(const TreeSnapshot& before, const TreeSnapshot& after) const;
+
+    // A plain text summary followed by one line per edit. Inserted and deleted subtrees are listed once, by their root
+    std::string report(const TreeDiffResult& diff, const TreeSnapshot& before, const TreeSnapshot& after,
+        const std::string& beforeName, const std::string& afterName) const;
+
+    // Reads a .treesy file, or the first tree in a bracket notation file
+    bool readFile(const std::string& path, TreeSnapshot& tree) const;
+
+    // Compares the tree on screen (before) with the one in path (after), and replaces it with both merged together,
+    // with inserted, deleted and relabelled nodes colored in. The tree on screen is kept until the comparison closes
+    bool showComparison(const std::string& path);
+    // Puts the tree that was on screen before the comparison back, or just forgets it if another tree has been opened
+    void closeComparison(bool restoreTree);
+    // The merged tree isn't the user's, so it shouldn't be saved over their file
+    bool isShowingComparison() const;
+
+    // Treesy --diff <before> <after> [report]. Returns 0 if the trees match, 1 if they don't and 2 if one couldn't be read
+    int runCommandLine(const std::string& beforePath, const std::string& afterPath, const std::string& reportPath) const;
+private:
+    // Everything compare() needs to know about one of the trees
+    struct TreeInfo {
+        std::vector<std::string> labels;
+        std::vector<std::vector<int>> children;
+        std::vector<int> roots;
+        std::vector<unsigned int> sizes;
+        // Equal hashes mean equal subtrees (labels and shape)
+        std::vector<uint64_t> hashes;
+    };
+
+    struct AlignedChild {
+        DIFF_TYPE type;
+        int before;
+        int after;
+    };
+
+    bool _showingComparison = false;
+    TreeSnapshot _beforeComparison;
+
+    static TreeInfo analyze(const TreeSnapshot& tree);
+    // An estimate of how many edits pairing the two subtrees will take
+    static unsigned int getPairCost(const TreeInfo& before, int a, const TreeInfo& after, int b);
+    static std::vector<AlignedChild> alignChildren(const TreeInfo& before, const std::vector<int>& a, const TreeInfo& after, const std::vector<int>& b);
+
+    static std::string getLabel(const SnapshotNode& node);
+};
+
+class TreeDiff {
+public:
+    static TreeDiffResult compare(const TreeSnapshot& before, const TreeSnapshot& after) {
+        return _instance.compare(before, after);
+    }
+
+    static std::string report(const TreeDiffResult& diff, const TreeSnapshot& before, const TreeSnapshot& after,
+        const std::string& beforeName, const std::string& afterName) {
+        return _instance.report(diff, before, after, beforeName, afterName);
+    }
+
+    static bool readFile(const std::string& path, TreeSnapshot& tree) {
+        return _instance.readFile(path, tree);
+    }
+
+    static bool showComparison(const std::string& path) {
+        return _instance.showComparison(path);
+    }
+
+    static void closeComparison(bool restoreTree = true) {
+        _instance.closeComparison(restoreTree);
+    }
+
+    static bool isShowingComparison() {
+        return _instance.isShowingComparison();
+    }
+
+    static int runCommandLine(const std::string& beforePath, const std::string& afterPath, const std::string& reportPath) {
+        return _instance.runCommandLine(beforePath, afterPath, reportPath);
+    }
+private:
+    static inline TreeDiffImpl _instance;
+};
+
+#endif
\ No newline at end of file
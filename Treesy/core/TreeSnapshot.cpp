@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "TreeSnapshot.h"
+#include <unordered_map>
+#include "../visual/VisualTree.h"
+
+TreeSnapshot TreeSnapshot::capture(VisualNode* root) {
+    TreeSnapshot snapshot;
+    std::unordered_map<VisualNode*, int> indices;
+
+    std::vector<std::pair<VisualNode*, int>> stack = { { root, -1 } };
+    while (!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        const int index = (int)snapshot.nodes.size();
+        indices[node] = index;
+
+        SnapshotNode snapshotNode;
+        snapshotNode.text = std::make_shared<const sf::String>(node->getText().getString());
+        if (node->hasSubscript()) snapshotNode.subscript = std::make_shared<const sf::String>(node->_subscript.getString());
+        snapshotNode.parent = parent;
+        snapshotNode.drawTriangle = node->_drawTriangle;
+        snapshotNode.curveAngle = node->_curveAngle;
+        snapshotNode.curveHeight = node->_curveHeight;
+        snapshot.nodes.push_back(snapshotNode);
+
+        // Pushed in reverse so they're visited left to right
+        const auto& children = node->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); it++) {
+            if ((*it)->isActive()) stack.push_back({ it->get(), index });
+        }
+    }
+
+    for (const auto& [node, index] : indices) {
+        if (!node->hasMovement() || node->_endPointNode == nullptr) continue;
+
+        const auto target = indices.find(node->_endPointNode.get());
+        if (target != indices.end()) snapshot.nodes.at(index).movementTarget = target->second;
+    }
+
+    return snapshot;
+}
+
+s_p<VisualNode> TreeSnapshot::build(VisualNode* parent) const {
+    // Same as adding a child by hand
+    if (parent != nullptr) parent->_drawTriangle = false;
+
+    const auto created = createNodes(parent, true);
+    return created.empty() ? nullptr : created.at(0);
+}
+
+int TreeSnapshot::addNode(int parent, s_p<const sf::String> text, s_p<const sf::String> subscript, bool drawTriangle) {
+    SnapshotNode node;
+    node.text = std::move(text);
+    node.subscript = std::move(subscript);
+    node.parent = parent;
+    node.drawTriangle = drawTriangle;
+    nodes.push_back(std::move(node));
+    return (int)nodes.size() - 1;
+}
+
+std::vector<s_p<VisualNode>> TreeSnapshot::createNodes(VisualNode* parent, bool buffered) const {
+    std::vector<s_p<VisualNode>> created;
+    created.reserve(nodes.size());
+
+    std::vector<size_t> childCounts(nodes.size(), 0);
+    for (const auto& snapshotNode : nodes) {
+        if (snapshotNode.parent != -1) childCounts.at(snapshotNode.parent)++;
+    }
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const auto& snapshotNode = nodes.at(i);
+        VisualNode* nodeParent = snapshotNode.parent == -1 ? parent : created.at(snapshotNode.parent).get();
+
+        s_p<VisualNode> node = nullptr;
+        if (buffered) node = VisualTree::addChild(nodeParent);
+        else {
+            const sf::Vector2f pos = VisualTreeImpl::getChildPosition(nodeParent);
+            node = VisualNode::create(nodeParent, pos.x, pos.y);
+        }
+        node->_children.reserve(childCounts.at(i));
+        if (nodeParent != nullptr) nodeParent->_children.push_back(node);
+
+        node->getText().setString(*snapshotNode.text);
+        if (snapshotNode.subscript != nullptr) node->_subscript.setString(*snapshotNode.subscript);
+        node->_drawTriangle = snapshotNode.drawTriangle;
+        node->_curveAngle = snapshotNode.curveAngle;
+        node->_curveHeight = snapshotNode.curveHeight;
+        created.push_back(node);
+    }
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes.at(i).movementTarget == -1) continue;
+        created.at(i)->_hasMovement = true;
+        created.at(i)->_endPointNode = created.at(nodes.at(i).movementTarget);
+    }
+
+    return created;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _TREE_SNAPSHOT_H
+#define _TREE_SNAPSHOT_H
+
+#include <vector>
+#include <SFML/System/String.hpp>
+#include "../../PennyEngine/core/Defines.h"
+#include "../visual/VisualNode.h"
+
+struct SnapshotNode {
+    // Labels are immutable and shared, so copies of a snapshot (and labels
+    // that repeat, like NP or VP) don't duplicate the text
+    s_p<const sf::String> text;
+    s_p<const sf::String> subscript = nullptr;
+
+    // Index of the parent in TreeSnapshot::nodes, or -1 for the root.
+    // Nodes are stored in preorder, so a parent always comes before its children
+    int parent = -1;
+
+    bool drawTriangle = false;
+
+    // Index of the node a movement line points to, or -1 for none
+    int movementTarget = -1;
+    float curveAngle = 0.f;
+    float curveHeight = 0.f;
+};
+
+// A detached copy of a (sub)tree that can be turned back into nodes any number of times.
+// Also the model importers and generators fill in to build a whole tree with VisualTree::build
+struct TreeSnapshot {
+    std::vector<SnapshotNode> nodes;
+
+    // Movement lines are only kept if both ends are inside the subtree
+    static TreeSnapshot capture(VisualNode* root);
+
+    // Creates the nodes as the last child of parent, or as a new root if parent is nullptr
+    s_p<VisualNode> build(VisualNode* parent) const;
+
+    // Adds a node and returns its index. The parent has to have been added already
+    int addNode(int parent, s_p<const sf::String> text, s_p<const sf::String> subscript = nullptr, bool drawTriangle = false);
+
+    friend class VisualTreeImpl;
+private:
+    std::vector<s_p<VisualNode>> createNodes(VisualNode* parent, bool buffered) const;
+};
+
+#endif
\ No newline at end of file
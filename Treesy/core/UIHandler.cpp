@@ -10,10 +10,18 @@
 #include "../../PennyEngine/ui/components/ToggleButton.h"
 #include "../../PennyEngine/core/Util.h"
 #include <Windows.h>
+#include <algorithm>
+#include <cctype>
 #include "../../PennyEngine/core/Logger.h"
 #include "../visual/VisualTree.h"
+#include "../visual/Minimap.h"
 #include "Settings.h"
 #include "Persistence.h"
+#include "History.h"
+#include "Corpus.h"
+#include "LabelIndex.h"
+#include "PngEncoder.h"
+#include "TreeDiff.h"
 
 void UIHandlerImpl::init() {
     // Subscripts
@@ -47,71 +55,130 @@ void UIHandlerImpl::init() {
     mainMenu->open();
     //
 
+    // Corpus
+    auto corpusMenu = pe::UI::addMenu("corpus");
+    corpusMenu->addComponent(new_s_p(pe::Button, ("corpus_previous", 0, 0, 3, 3, "<", this)));
+    corpusMenu->addComponent(new_s_p(pe::Button, ("corpus_next", 0, 0, 3, 3, ">", this)));
+    corpusMenu->addComponent(new_s_p(pe::TextField, ("corpusField", 0, 0, 9, 4, "")));
+    corpusMenu->addComponent(new_s_p(pe::Button, ("corpus_go", 0, 0, 5, 3, "Go to", this)));
+    corpusMenu->addComponent(new_s_p(pe::Button, ("corpus_find", 0, 0, 5, 3, "Find", this)));
+    corpusMenu->addComponent(new_s_p(pe::Button, ("corpus_close", 0, 0, 5, 3, "Close", this)));
+    auto corpusPanel = new_s_p(pe::Panel, ("corpusPanel", 50, 90, 40, 12, "", true));
+    corpusPanel->setTextPosition({ 50.f, 18.f });
+    corpusMenu->addComponent(corpusPanel);
+    corpusPanel->attachAt("corpus_previous", { 8, 62 });
+    corpusPanel->attachAt("corpus_next", { 20, 62 });
+    corpusPanel->attachAt("corpusField", { 42, 62 });
+    corpusPanel->attachAt("corpus_go", { 62, 62 });
+    corpusPanel->attachAt("corpus_find", { 77, 62 });
+    corpusPanel->attachAt("corpus_close", { 92, 62 });
+    //
+
+    // Search
+    auto searchMenu = pe::UI::addMenu("search");
+    searchMenu->addComponent(new_s_p(pe::TextField, ("searchField", 0, 0, 12, 4, "")));
+    searchMenu->addComponent(new_s_p(pe::ToggleButton, ("search_regex", 0, 0, 0.6f, 0.35f, "Regex: ", this)));
+    searchMenu->addComponent(new_s_p(pe::Button, ("search_previous", 0, 0, 3, 3, "<", this)));
+    searchMenu->addComponent(new_s_p(pe::Button, ("search_next", 0, 0, 3, 3, ">", this)));
+    searchMenu->addComponent(new_s_p(pe::Button, ("search_close", 0, 0, 5, 3, "Close", this)));
+    auto searchPanel = new_s_p(pe::Panel, ("searchPanel", 50, 10, 40, 12, "Find nodes", true));
+    searchPanel->setTextPosition({ 50.f, 18.f });
+    searchMenu->addComponent(searchPanel);
+    searchPanel->attachAt("searchField", { 22, 62 });
+    searchPanel->attachAt("search_regex", { 52, 62 });
+    searchPanel->attachAt("search_previous", { 70, 62 });
+    searchPanel->attachAt("search_next", { 80, 62 });
+    searchPanel->attachAt("search_close", { 92, 62 });
+    //
+
+    // Menus below here are only built when they're first opened, and released after they've been closed for a while
+
+    // Minimap
+    pe::UI::addMenu("minimap")->setFactory([](pe::Menu& minimapMenu) {
+        minimapMenu.addComponent(new_s_p(Minimap, ("minimapView", 0, 0, 18, 22)));
+        auto minimapPanel = new_s_p(pe::Panel, ("minimapPanel", 88, 78, 20, 30, "Overview", true));
+        minimapPanel->setTextPosition({ 50.f, 10.f });
+        minimapMenu.addComponent(minimapPanel);
+        minimapPanel->attachAt(minimapMenu.getComponent("minimapView"), { 50, 58 });
+    }, true);
+    //
+
     // Settings
     auto settingsMenu = pe::UI::addMenu("settings");
-    settingsMenu->addComponent(new_s_p(pe::Slider, ("widthSlider", 7, 53.f, { 8, 1.f }, { 1.f, 2.f }, "Horizontal Spacing", this)));
-    pe::Slider* horzslider = dynamic_cast<pe::Slider*>(settingsMenu->getComponent("widthSlider").get());
-    horzslider->setValue(Settings::horzSpacing / 500.f + 0.5f);
-    horzslider->getText().setCharacterSize(pe::UI::percentToScreenWidth(1.f));
-
-    //settingsMenu->addComponent(new_s_p(pe::Slider, ("heightSlider", 0, 0, { 8.f, 1.f }, { 1.f, 2.f }, "Vertical Spacing", this))); 
-    //pe::Slider* vertslider = dynamic_cast<pe::Slider*>(settingsMenu->getComponent("heightSlider").get());
-    ////vertslider->setValue(0.f);
-    //vertslider->getText().setCharacterSize(pe::UI::percentToScreenWidth(1.f));
-
-    settingsMenu->addComponent(new_s_p(pe::ToggleButton, ("termLines", 0, 0, 0.6f, 0.35f, "Terminal Lines: ", this)));
-    pe::ToggleButton* termLinesButton = dynamic_cast<pe::ToggleButton*>(settingsMenu->getComponent("termLines").get());
-    termLinesButton->setValue(Settings::showTermLines);
-
-    settingsMenu->addComponent(new_s_p(pe::Button, ("open_colors", 0, 0, 8, 3, "Colors", this)));
-    settingsMenu->addComponent(new_s_p(pe::Button, ("close_settings", 0, 0, 8, 3, "Close", this)));
-
-    auto settingsPanel = new_s_p(pe::Panel, ("settingsPanel", 7, 60, 13, 30, "Settings", true));
-    settingsPanel->setTextPosition(50.f, 12.f);
-    settingsMenu->addComponent(settingsPanel);
-    settingsPanel->attachAt("widthSlider", { 50, 22 });
-    settingsPanel->attachAt("heightSlider", { 50, 37 });
-    settingsPanel->attachAt("termLines", { 82, 50 });
-    settingsPanel->attachAt("open_colors", { 50, 71 });
-    settingsPanel->attachAt("close_settings", { 50, 84 });
+    settingsMenu->setFactory([this](pe::Menu& settingsMenu) {
+        settingsMenu.addComponent(new_s_p(pe::Slider, ("widthSlider", 7, 53.f, { 8, 1.f }, { 1.f, 2.f }, "Horizontal Spacing", this)));
+        pe::Slider* horzslider = dynamic_cast<pe::Slider*>(settingsMenu.getComponent("widthSlider").get());
+        horzslider->setValue(Settings::horzSpacing / 500.f + 0.5f);
+        horzslider->getText().setCharacterSize(pe::UI::percentToScreenWidth(1.f));
+
+        //settingsMenu.addComponent(new_s_p(pe::Slider, ("heightSlider", 0, 0, { 8.f, 1.f }, { 1.f, 2.f }, "Vertical Spacing", this))); 
+        //pe::Slider* vertslider = dynamic_cast<pe::Slider*>(settingsMenu.getComponent("heightSlider").get());
+        ////vertslider->setValue(0.f);
+        //vertslider->getText().setCharacterSize(pe::UI::percentToScreenWidth(1.f));
+
+        settingsMenu.addComponent(new_s_p(pe::ToggleButton, ("termLines", 0, 0, 0.6f, 0.35f, "Terminal Lines: ", this)));
+        pe::ToggleButton* termLinesButton = dynamic_cast<pe::ToggleButton*>(settingsMenu.getComponent("termLines").get());
+        termLinesButton->setValue(Settings::showTermLines);
+
+        settingsMenu.addComponent(new_s_p(pe::ToggleButton, ("draftExports", 0, 0, 0.6f, 0.35f, "Draft Exports: ", this)));
+        pe::ToggleButton* draftExportsButton = dynamic_cast<pe::ToggleButton*>(settingsMenu.getComponent("draftExports").get());
+        draftExportsButton->setValue(Settings::draftExports);
+
+        settingsMenu.addComponent(new_s_p(pe::Button, ("open_colors", 0, 0, 8, 3, "Colors", this)));
+        settingsMenu.addComponent(new_s_p(pe::Button, ("close_settings", 0, 0, 8, 3, "Close", this)));
+
+        auto settingsPanel = new_s_p(pe::Panel, ("settingsPanel", 7, 60, 13, 30, "Settings", true));
+        settingsPanel->setTextPosition(50.f, 12.f);
+        settingsMenu.addComponent(settingsPanel);
+        settingsPanel->attachAt(settingsMenu.getComponent("widthSlider"), { 50, 22 });
+        settingsPanel->attachAt(settingsMenu.getComponent("termLines"), { 82, 42 });
+        settingsPanel->attachAt(settingsMenu.getComponent("draftExports"), { 82, 56 });
+        settingsPanel->attachAt(settingsMenu.getComponent("open_colors"), { 50, 71 });
+        settingsPanel->attachAt(settingsMenu.getComponent("close_settings"), { 50, 84 });
+    }, true);
     //
 
     // Colors
     auto colorsMenu = pe::UI::addMenu("colors");
     settingsMenu->addChild(colorsMenu);
-
-    colorsMenu->addComponent(new_s_p(pe::Button, ("bgColor", 0, 0, 9, 3, "Background", this)));
-    colorsMenu->addComponent(new_s_p(pe::Button, ("lineColor", 0, 0, 9, 3, "Lines", this)));
-    colorsMenu->addComponent(new_s_p(pe::Button, ("termColor", 0, 0, 9, 3, "Terminals", this)));
-    colorsMenu->addComponent(new_s_p(pe::Button, ("nonTermColor", 0, 0, 9, 3, "Non-terminals", this)));
-
-    colorsMenu->addComponent(new_s_p(pe::Button, ("close_colors", 7, 72, 6, 3, "Back", this)));
-
-    colorsMenu->addComponent(settingsPanel);
-    settingsPanel->attachAt("bgColor", { 50, 25 });
-    settingsPanel->attachAt("lineColor", { 50, 38 });
-    settingsPanel->attachAt("termColor", { 50, 51 });
-    settingsPanel->attachAt("nonTermColor", { 50, 64 });
-    settingsPanel->attachAt("close_colors", { 50, 80 });
+    colorsMenu->setFactory([this](pe::Menu& colorsMenu) {
+        colorsMenu.addComponent(new_s_p(pe::Button, ("bgColor", 0, 0, 9, 3, "Background", this)));
+        colorsMenu.addComponent(new_s_p(pe::Button, ("lineColor", 0, 0, 9, 3, "Lines", this)));
+        colorsMenu.addComponent(new_s_p(pe::Button, ("termColor", 0, 0, 9, 3, "Terminals", this)));
+        colorsMenu.addComponent(new_s_p(pe::Button, ("nonTermColor", 0, 0, 9, 3, "Non-terminals", this)));
+
+        colorsMenu.addComponent(new_s_p(pe::Button, ("close_colors", 7, 72, 6, 3, "Back", this)));
+
+        // Same place and title as the settings panel, which this replaces while it's open
+        auto colorsPanel = new_s_p(pe::Panel, ("colorsPanel", 7, 60, 13, 30, "Settings", true));
+        colorsPanel->setTextPosition(50.f, 12.f);
+        colorsMenu.addComponent(colorsPanel);
+        colorsPanel->attachAt(colorsMenu.getComponent("bgColor"), { 50, 25 });
+        colorsPanel->attachAt(colorsMenu.getComponent("lineColor"), { 50, 38 });
+        colorsPanel->attachAt(colorsMenu.getComponent("termColor"), { 50, 51 });
+        colorsPanel->attachAt(colorsMenu.getComponent("nonTermColor"), { 50, 64 });
+        colorsPanel->attachAt(colorsMenu.getComponent("close_colors"), { 50, 80 });
+    }, true);
     //
 
     // Color
-    auto colorMenu = pe::UI::addMenu("color");
-    colorMenu->addComponent(new_s_p(pe::Slider, ("c_red_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Red", this)));
-    colorMenu->addComponent(new_s_p(pe::Slider, ("c_green_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Green", this)));
-    colorMenu->addComponent(new_s_p(pe::Slider, ("c_blue_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Blue", this)));
-    colorMenu->addComponent(new_s_p(pe::Slider, ("c_alpha_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Alpha", this)));
-    colorMenu->addComponent(new_s_p(pe::Button, ("close_color", 0, 0, 8, 3, "Close", this)));
-
-    auto colorPanel = new_s_p(pe::Panel, ("colorPanel", 80, 50, 13, 40, "", true));
-    colorPanel->setTextPosition(50.f, 8.f);
-    colorPanel->attachAt("c_red_slider", { 50, 15 });
-    colorPanel->attachAt("c_green_slider", { 50, 35 });
-    colorPanel->attachAt("c_blue_slider", { 50, 55 });
-    colorPanel->attachAt("c_alpha_slider", { 50, 75 });
-    colorPanel->attachAt("close_color", { 50, 95 });
-
-    colorMenu->addComponent(colorPanel);
+    pe::UI::addMenu("color")->setFactory([this](pe::Menu& colorMenu) {
+        colorMenu.addComponent(new_s_p(pe::Slider, ("c_red_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Red", this)));
+        colorMenu.addComponent(new_s_p(pe::Slider, ("c_green_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Green", this)));
+        colorMenu.addComponent(new_s_p(pe::Slider, ("c_blue_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Blue", this)));
+        colorMenu.addComponent(new_s_p(pe::Slider, ("c_alpha_slider", 0, 0, { 8, 1.f }, { 1.f, 2.f }, "Alpha", this)));
+        colorMenu.addComponent(new_s_p(pe::Button, ("close_color", 0, 0, 8, 3, "Close", this)));
+
+        auto colorPanel = new_s_p(pe::Panel, ("colorPanel", 80, 50, 13, 40, "", true));
+        colorPanel->setTextPosition(50.f, 8.f);
+        colorPanel->attachAt(colorMenu.getComponent("c_red_slider"), { 50, 15 });
+        colorPanel->attachAt(colorMenu.getComponent("c_green_slider"), { 50, 35 });
+        colorPanel->attachAt(colorMenu.getComponent("c_blue_slider"), { 50, 55 });
+        colorPanel->attachAt(colorMenu.getComponent("c_alpha_slider"), { 50, 75 });
+        colorPanel->attachAt(colorMenu.getComponent("close_color"), { 50, 95 });
+
+        colorMenu.addComponent(colorPanel);
+    }, true);
     //
 }
 
@@ -119,6 +186,11 @@ void UIHandler::init() {
     _instance.init();
 }
 
+// Anything that isn't a .treesy file is treated as labelled bracket notation
+static bool isBracketFile(const std::string& path) {
+    return !path.empty() && !pe::stringEndsWith(path, ".treesy");
+}
+
 void UIHandlerImpl::buttonPressed(std::string buttonId) {
     if (pe::stringStartsWith(buttonId, "close_")) {
         const auto& menu = pe::UI::getMenu(pe::splitString(buttonId, "close_")[1]);
@@ -132,12 +204,59 @@ void UIHandlerImpl::buttonPressed(std::string buttonId) {
     } else if (buttonId == "exit") {
         PennyEngine::stop();
     } else if (buttonId == "save") {
+        // The merged tree has the deleted nodes in it too, so saving it over the user's file would be a mistake
+        if (TreeDiff::isShowingComparison()) {
+            const int answer = MessageBox(NULL,
+                L"A comparison is showing, so this would save both trees merged together.\nPress ctrl+D to close the comparison and get your tree back.\n\nSave the merged tree anyway?",
+                L"Treesy", MB_YESNO | MB_ICONWARNING | MB_DEFBUTTON2);
+            if (answer != IDYES) return;
+        }
+
         const std::string path = UIHandler::getSavePath();
-        Persistence::save(path);
+        if (isBracketFile(path)) Persistence::saveBrackets(path);
+        else Persistence::save(path);
     } else if (buttonId == "load") {
         const std::string path = UIHandler::getLoadPath();
-        VisualTree::reset();
-        Persistence::load(path);
+        // Opening another tree ends the comparison without bringing back the tree from before it
+        if (!path.empty()) TreeDiff::closeComparison(false);
+        const auto& corpusMenu = pe::UI::getMenu("corpus");
+        if (isBracketFile(path)) {
+            // Single trees open the same way, just without the browser
+            if (Corpus::open(path) && Corpus::getTreeCount() > 1) corpusMenu->open();
+            else corpusMenu->close();
+        } else {
+            Corpus::close();
+            corpusMenu->close();
+            VisualTree::reset();
+            History::clear();
+            Persistence::load(path);
+        }
+    } else if (buttonId == "search_previous") {
+        LabelIndex::previous();
+    } else if (buttonId == "search_next") {
+        LabelIndex::next();
+    } else if (buttonId == "search_close") {
+        LabelIndex::clearResults();
+        pe::UI::getMenu("search")->close();
+    } else if (buttonId == "corpus_previous") {
+        Corpus::previous();
+    } else if (buttonId == "corpus_next") {
+        Corpus::next();
+    } else if (buttonId == "corpus_go") {
+        const std::string text = pe::UI::getMenu("corpus")->getComponent("corpusField")->getText().getString();
+        try {
+            const size_t index = std::stoul(text);
+            if (index > 0) Corpus::show(index - 1);
+        } catch (std::exception ex) {
+            pe::Logger::log("Not a tree number: " + text);
+        }
+    } else if (buttonId == "corpus_find") {
+        const auto utf8 = pe::UI::getMenu("corpus")->getComponent("corpusField")->getText().getString().toUtf8();
+        const std::string query(utf8.begin(), utf8.end());
+        if (!Corpus::find(query)) pe::Logger::log("Did not find " + query);
+    } else if (buttonId == "corpus_close") {
+        Corpus::close();
+        pe::UI::getMenu("corpus")->close();
     } else if (buttonId == "bgColor") {
         pe::UI::getMenu("color")->open();
         _selectedColor = &Settings::bgColor;
@@ -178,6 +297,7 @@ void UIHandlerImpl::sliderMoved(std::string sliderId, float value) {
 
 void UIHandlerImpl::toggleButtonPressed(std::string buttonid, bool newValue) {
     if (buttonid == "termLines") Settings::showTermLines = newValue;
+    else if (buttonid == "draftExports") Settings::draftExports = newValue;
 }
 
 void UIHandlerImpl::setColorSliders() {
@@ -200,13 +320,17 @@ void UIHandlerImpl::saveImage(std::string path) {
     float highestX = 0;
     float highestY = 0;
     for (const auto& node : VisualTree::getNodes()) {
+        if (node->isHiddenByCollapse()) continue;
+
         const sf::Vector2f pos = node->getPosition();
         const sf::Vector2f size = { node->getBounds().width, node->getBounds().height };
+        // Leaves room for the summary drawn under collapsed nodes
+        const float summaryHeight = node->isCollapsed() ? pe::UI::percentToScreenHeight(Settings::termVerticalDistance) : 0.f;
 
         lowestX = std::min(pos.x, lowestX);
         lowestY = std::min(pos.y, lowestY);
         highestX = std::max(pos.x + size.x, highestX);
-        highestY = std::max(std::max(pos.y + size.y, node->getMovementLineVertex()), highestY);
+        highestY = std::max(std::max(pos.y + size.y + summaryHeight, node->getMovementLineVertex()), highestY);
     }
     const sf::Vector2f size = { highestX - lowestX, highestY - lowestY };
     const sf::View view({ lowestX + size.x / 2.f, lowestY + size.y / 2.f }, size);
@@ -225,7 +349,14 @@ void UIHandlerImpl::saveImage(std::string path) {
     VisualTree::draw(outputSurface);
     outputSurface.display();
 
-    const bool result = outputSurfaceTexture.copyToImage().saveToFile(path);
+    const sf::Image image = outputSurfaceTexture.copyToImage();
+    // PNGs are compressed in parallel. Other formats are left to SFML
+    const size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? "" : path.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    const bool result = extension == ".png"
+        ? PngEncoder::save(image, path, Settings::draftExports ? PNG_COMPRESSION::FAST : PNG_COMPRESSION::NORMAL)
+        : image.saveToFile(path);
 
     if (!result) {
         pe::Logger::log("Failed to save: " + path);
@@ -275,7 +406,7 @@ std::string UIHandler::getSavePath() {
 
     ofn.lStructSize = sizeof(ofn);
     ofn.hwndOwner = NULL;
-    ofn.lpstrFilter = (LPCWSTR)L"Treesy Files (*.treesy)\0*.treesy\0";
+    ofn.lpstrFilter = (LPCWSTR)L"Treesy Files (*.treesy)\0*.treesy\0Bracketed Trees (*.txt;*.mrg;*.tree)\0*.txt;*.mrg;*.tree\0All Files (*.*)\0*.*\0";
     ofn.lpstrFile = szFileName;
     ofn.nMaxFile = MAX_PATH;
     ofn.Flags = OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
@@ -294,7 +425,7 @@ std::string UIHandler::getLoadPath() {
 
     ofn.lStructSize = sizeof(ofn);
     ofn.hwndOwner = NULL;
-    ofn.lpstrFilter = (LPCWSTR)L"Treesy Files (*.treesy)\0*.treesy\0";
+    ofn.lpstrFilter = (LPCWSTR)L"Treesy Files (*.treesy)\0*.treesy\0Bracketed Trees (*.txt;*.mrg;*.tree)\0*.txt;*.mrg;*.tree\0All Files (*.*)\0*.*\0";
     ofn.lpstrFile = szFileName;
     ofn.nMaxFile = MAX_PATH;
     ofn.Flags = OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
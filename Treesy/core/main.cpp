@@ -5,10 +5,19 @@
 
 #include "../../PennyEngine/PennyEngine.h"
 #include "ProgramManager.h"
+#include "BenchmarkManager.h"
 #include "Settings.h"
+#include "TreeDiff.h"
 
 int main(int argc, char* argv[]) {
-    Settings::load();
+    // Compares two trees without opening a window, for scripts
+    if (argc > 3 && std::string(argv[1]) == "--diff") {
+        return TreeDiff::runCommandLine(argv[2], argv[3], argc > 4 ? argv[4] : "");
+    }
+
+    // Benchmarks run against the default settings so results are comparable between machines
+    const bool benchmark = argc > 1 && std::string(argv[1]) == "--bench";
+    if (!benchmark) PennyEngine::addStartupTask(Settings::load);
 
     PennyEngine::setAppName("Treesy");
     PennyEngine::setWindowTitle(PennyEngine::getAppName());
@@ -20,7 +29,24 @@ int main(int argc, char* argv[]) {
     PennyEngine::setRenderResolution(PennyEngine::getDisplayResolution());
     PennyEngine::setFramerateLimit(60);
 
+    if (benchmark) {
+        unsigned int maxNodes = DEFAULT_BENCHMARK_MAX_NODES;
+        if (argc > 2) {
+            try {
+                maxNodes = (unsigned int)std::stoul(argv[2]);
+            } catch (std::exception ex) {
+                pe::Logger::log("Not a node count: " + std::string(argv[2]) + ", using " + std::to_string(maxNodes));
+            }
+        }
+
+        BenchmarkManager benchmarkManager(maxNodes);
+        PennyEngine::start(&benchmarkManager);
+        return 0;
+    }
+
     ProgramManager programManager;
+    // A file passed on the command line (e.g. by opening a .treesy file with Treesy) is opened on startup
+    if (argc > 1) programManager.openOnStartup(argv[1]);
 
     PennyEngine::start(&programManager);
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <cmath>
 
@@ -33,6 +34,12 @@ public:
         target.draw(vertices, 4, sf::Quads);
     }
 
+    // For batching many lines into one draw call; batch has to be made of quads
+    void appendTo(sf::VertexArray& batch) const {
+        for (int i = 0; i < 4; ++i)
+            batch.append(vertices[i]);
+    }
+
     const sf::Vector2f point1, point2;
 private:
     sf::Vertex vertices[4];
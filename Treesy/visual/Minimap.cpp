@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "Minimap.h"
+#include "VisualTree.h"
+#include "../../PennyEngine/PennyEngine.h"
+#include "../../PennyEngine/core/Logger.h"
+#include "../core/Settings.h"
+#include <SFML/Graphics/Sprite.hpp>
+
+static std::array<sf::Color, 4> getColors() {
+    return { Settings::bgColor, Settings::lineColor, Settings::termColor, Settings::nonTermColor };
+}
+
+Minimap::Minimap(std::string id, float x, float y, float width, float height) : MenuComponent(id, x, y, width, height) {
+}
+
+void Minimap::update() {
+    if (!_hasTexture || VisualTree::getLayoutRevision() != _renderedRevision || getColors() != _renderedColors) redraw();
+}
+
+void Minimap::redraw() {
+    if (!_hasTexture) {
+        if (!_texture.create((unsigned int)_size.x, (unsigned int)_size.y)) {
+            pe::Logger::log("Failed to create minimap texture");
+            return;
+        }
+        _texture.setSmooth(true);
+        _hasTexture = true;
+    }
+
+    _renderedRevision = VisualTree::getLayoutRevision();
+    _renderedColors = getColors();
+
+    // Fits the tree inside the minimap without stretching it, with a little room around the edges
+    const sf::FloatRect bounds = VisualTree::getTreeBounds();
+    const float margin = 1.1f;
+    const float scale = std::max(bounds.width / _size.x, bounds.height / _size.y) * margin;
+    const sf::Vector2f areaSize(_size.x * std::max(scale, 0.01f), _size.y * std::max(scale, 0.01f));
+    _area = sf::FloatRect(
+        bounds.left + bounds.width / 2.f - areaSize.x / 2.f, bounds.top + bounds.height / 2.f - areaSize.y / 2.f,
+        areaSize.x, areaSize.y
+    );
+
+    _texture.setView(sf::View(_area));
+    _texture.clear(Settings::bgColor);
+    VisualTree::drawOverview(_texture);
+    _texture.display();
+}
+
+void Minimap::render(sf::RenderTexture& surface, const sf::RenderStates& states) {
+    if (!_hasTexture) return;
+
+    sf::Sprite sprite(_texture.getTexture());
+    sprite.setPosition(_pos);
+    surface.draw(sprite, states);
+
+    draw(surface);
+}
+
+void Minimap::draw(sf::RenderTexture& surface) {
+    const sf::View& camera = PennyEngine::getCamera();
+    const sf::Vector2f scale(_size.x / _area.width, _size.y / _area.height);
+
+    // Kept inside the minimap so it still shows which way the camera is when it's far from the tree
+    const float left = std::max(_pos.x, _pos.x + (camera.getCenter().x - camera.getSize().x / 2.f - _area.left) * scale.x);
+    const float top = std::max(_pos.y, _pos.y + (camera.getCenter().y - camera.getSize().y / 2.f - _area.top) * scale.y);
+    const float right = std::min(_pos.x + _size.x, _pos.x + (camera.getCenter().x + camera.getSize().x / 2.f - _area.left) * scale.x);
+    const float bottom = std::min(_pos.y + _size.y, _pos.y + (camera.getCenter().y + camera.getSize().y / 2.f - _area.top) * scale.y);
+    if (right <= left || bottom <= top) return;
+
+    sf::RectangleShape viewRect({ right - left, bottom - top });
+    viewRect.setPosition(left, top);
+    viewRect.setFillColor(sf::Color::Transparent);
+    viewRect.setOutlineColor(Settings::nonTermColor);
+    viewRect.setOutlineThickness(-2.f);
+    surface.draw(viewRect);
+}
+
+void Minimap::moveCamera(const int mx, const int my) {
+    const sf::Vector2f world(
+        _area.left + ((float)mx - _pos.x) / _size.x * _area.width,
+        _area.top + ((float)my - _pos.y) / _size.y * _area.height
+    );
+    PennyEngine::getCamera().setCenter(world);
+}
+
+void Minimap::mouseButtonPressed(const int mx, const int my, const int button) {
+    if (button != sf::Mouse::Left || !getBounds().contains((float)mx, (float)my)) return;
+
+    _mouseDown = true;
+    moveCamera(mx, my);
+}
+
+void Minimap::mouseButtonReleased(const int mx, const int my, const int button) {
+    _mouseDown = false;
+}
+
+void Minimap::mouseMoved(const int mx, const int my) {
+    if (!_mouseDown) return;
+
+    // Dragging past the edges stops at them
+    const sf::FloatRect bounds = getBounds();
+    moveCamera(
+        (int)std::min(std::max((float)mx, bounds.left), bounds.left + bounds.width),
+        (int)std::min(std::max((float)my, bounds.top), bounds.top + bounds.height)
+    );
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _MINIMAP_H
+#define _MINIMAP_H
+
+#include <array>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include "../../PennyEngine/ui/components/MenuComponent.h"
+
+/*
+    Shows the whole tree with a rectangle around the part the camera
+    can see. Clicking or dragging on it moves the camera there.
+
+    The tree is drawn once into a texture the size of the minimap and
+    only drawn again when VisualTree's layout revision or one of the
+    colors it's drawn with changes, so an open minimap costs one
+    textured quad a frame.
+*/
+class Minimap : public pe::MenuComponent {
+public:
+    Minimap(std::string id, float x, float y, float width, float height);
+protected:
+    void update();
+    void render(sf::RenderTexture& surface, const sf::RenderStates& states = sf::RenderStates::Default);
+    void draw(sf::RenderTexture& surface);
+
+    virtual void mouseButtonPressed(const int mx, const int my, const int button);
+    virtual void mouseButtonReleased(const int mx, const int my, const int button);
+    virtual void mouseMoved(const int mx, const int my);
+private:
+    sf::RenderTexture _texture;
+    bool _hasTexture = false;
+
+    unsigned int _renderedRevision = 0;
+    // Background, line, terminal and non-terminal colors
+    std::array<sf::Color, 4> _renderedColors;
+    // The part of the world drawn into the texture
+    sf::FloatRect _area;
+
+    bool _mouseDown = false;
+
+    void redraw();
+    void moveCamera(const int mx, const int my);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#include "TextBatch.h"
+
+void TextBatch::clear() {
+    // Keeps the arrays' storage for the next frame
+    for (auto& page : _pages) {
+        page.vertices.clear();
+    }
+}
+
+void TextBatch::add(const sf::Text& text, TextBatchEntry& entry) {
+    if (text.getFont() == nullptr) return;
+
+    if (entry.font != text.getFont() || entry.characterSize != text.getCharacterSize() || entry.string != text.getString()) {
+        layout(text, entry);
+    }
+    if (entry.vertices.empty()) return;
+
+    Page* page = nullptr;
+    for (auto& candidate : _pages) {
+        if (candidate.font == entry.font && candidate.characterSize == entry.characterSize) {
+            page = &candidate;
+            break;
+        }
+    }
+    if (page == nullptr) {
+        _pages.push_back({ entry.font, entry.characterSize, sf::VertexArray(sf::Triangles) });
+        page = &_pages.back();
+    }
+
+    const sf::Transform& transform = text.getTransform();
+    const sf::Color color = text.getFillColor();
+    for (const auto& vertex : entry.vertices) {
+        page->vertices.append(sf::Vertex(transform.transformPoint(vertex.position), color, vertex.texCoords));
+    }
+}
+
+void TextBatch::draw(sf::RenderTarget& surface) const {
+    for (const auto& page : _pages) {
+        if (page.vertices.getVertexCount() == 0) continue;
+
+        // Fetched at draw time since adding glyphs can grow the page texture
+        sf::RenderStates states;
+        states.texture = &page.font->getTexture(page.characterSize);
+        surface.draw(page.vertices, states);
+    }
+}
+
+void TextBatch::layout(const sf::Text& text, TextBatchEntry& entry) {
+    entry.string = text.getString();
+    entry.font = text.getFont();
+    entry.characterSize = text.getCharacterSize();
+    entry.vertices.clear();
+
+    // Matches the geometry sf::Text builds for a regular style, padding included
+    const sf::Font& font = *entry.font;
+    const unsigned int size = entry.characterSize;
+    const float whitespaceWidth = font.getGlyph(L' ', size, false).advance;
+    const float lineSpacing = font.getLineSpacing(size);
+    const float padding = 1.f;
+
+    float x = 0.f;
+    float y = (float)size;
+    sf::Uint32 previous = 0;
+    for (const sf::Uint32 current : entry.string) {
+        x += font.getKerning(previous, current, size);
+        previous = current;
+
+        if (current == L' ') {
+            x += whitespaceWidth;
+            continue;
+        } else if (current == L'\t') {
+            x += whitespaceWidth * 4.f;
+            continue;
+        } else if (current == L'\n') {
+            x = 0.f;
+            y += lineSpacing;
+            continue;
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(current, size, false);
+        const float left = x + glyph.bounds.left - padding;
+        const float top = y + glyph.bounds.top - padding;
+        const float right = x + glyph.bounds.left + glyph.bounds.width + padding;
+        const float bottom = y + glyph.bounds.top + glyph.bounds.height + padding;
+
+        const float u1 = (float)glyph.textureRect.left - padding;
+        const float v1 = (float)glyph.textureRect.top - padding;
+        const float u2 = (float)(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        const float v2 = (float)(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        entry.vertices.push_back(sf::Vertex({ left, top }, { u1, v1 }));
+        entry.vertices.push_back(sf::Vertex({ right, top }, { u2, v1 }));
+        entry.vertices.push_back(sf::Vertex({ left, bottom }, { u1, v2 }));
+        entry.vertices.push_back(sf::Vertex({ left, bottom }, { u1, v2 }));
+        entry.vertices.push_back(sf::Vertex({ right, top }, { u2, v1 }));
+        entry.vertices.push_back(sf::Vertex({ right, bottom }, { u2, v2 }));
+
+        x += glyph.advance;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Josh Sellers
+// Licensed under the MIT License. See LICENSE file.
+
+#ifndef _TEXT_BATCH_H
+#define _TEXT_BATCH_H
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <vector>
+
+// Glyph quads for one piece of text, in the text's local coordinates.
+// Only laid out again when the string, font or character size changes
+struct TextBatchEntry {
+    sf::String string;
+    const sf::Font* font = nullptr;
+    unsigned int characterSize = 0;
+    std::vector<sf::Vertex> vertices;
+};
+
+/*
+    Collects sf::Texts into one vertex array per glyph page, so any number
+    of labels can be drawn in a couple of draw calls. SFML keeps a separate
+    page for each character size, so there's one array for each size in use.
+
+    Texts are added with their current transform and fill color every frame;
+    outline and style (bold, underline...) aren't supported.
+*/
+class TextBatch {
+public:
+    void clear();
+    void add(const sf::Text& text, TextBatchEntry& entry);
+    void draw(sf::RenderTarget& surface) const;
+private:
+    struct Page {
+        const sf::Font* font;
+        unsigned int characterSize;
+        sf::VertexArray vertices;
+    };
+    std::vector<Page> _pages;
+
+    static void layout(const sf::Text& text, TextBatchEntry& entry);
+};
+
+#endif
\ No newline at end of file
@@ -8,10 +8,25 @@
 #include "../../PennyEngine/core/Logger.h"
 #include "Line.h"
 #include "../core/Settings.h"
+#include "../../PennyEngine/core/ObjectPool.h"
+#include "../core/History.h"
 
 
-VisualNode::VisualNode(VisualNode* parent, float x, float y, const std::string id) : TextField(id == "" ? pe::generateUID() : id, x, y, 3, 5, "", "XP") {
+// A node only ever needs a step or two, since its parent is settled first
+constexpr int MAX_SETTLE_STEPS = 16;
+
+static NodeId generateNodeId() {
+    static NodeId nextNodeId = 1;
+    return nextNodeId++;
+}
+
+s_p<VisualNode> VisualNode::create(VisualNode* parent, float x, float y) {
+    return std::allocate_shared<VisualNode>(pe::PoolAllocator<VisualNode>(), parent, x, y);
+}
+
+VisualNode::VisualNode(VisualNode* parent, float x, float y) : TextField("node", x, y, 3, 5, "", "XP"), _nodeId(generateNodeId()) {
     _parent = parent;
+    _hiddenByCollapse = parent != nullptr && (parent->_collapsed || parent->_hiddenByCollapse);
     show();
     _fieldText.setFillColor(Settings::nonTermColor);
     _fieldText.setCharacterSize(pe::UI::percentToScreenWidth(2.5f));
@@ -54,6 +69,12 @@ VisualNode::VisualNode(VisualNode* parent, float x, float y, const std::string i
 }
 
 void VisualNode::tick() {
+    // Hidden nodes only need to notice when they're deleted along with an ancestor
+    if (_hiddenByCollapse) {
+        if (hasParent() && !_parent->isActive()) hide();
+        return;
+    }
+
     update();
 }
 
@@ -70,12 +91,18 @@ void VisualNode::visualize(sf::RenderTexture& surface) {
     }
 }
 
+NodeId VisualNode::getId() const {
+    return _nodeId;
+}
+
 sf::Vector2f VisualNode::getPosition() const {
     return { getBounds().left, getBounds().top };
 }
 
 
 void VisualNode::addChild(bool left) {
+    setCollapsed(false);
+
     if (!Settings::showTermLines && !hasChildren() && hasParent() && !_drawTriangle && getParent()->getChildren().size() == 1) 
         move({ 0, pe::UI::percentToScreenHeight(Settings::getTermDistance()) });
 
@@ -87,6 +114,7 @@ void VisualNode::addChild(bool left) {
         _children.push_back(child);
     }
 
+    History::recordAddition(child.get(), _drawTriangle);
     _drawTriangle = false;
 }
 
@@ -142,6 +170,24 @@ void VisualNode::update() {
         _hideInterface = false;
     }
 
+    updateSize();
+
+    _children.erase(std::remove_if(_children.begin(), _children.end(), [](s_p<VisualNode> node) {return !node->isActive(); }), _children.end());
+
+    updateVerticalPosition();
+
+    if (_enteringSubscript) {
+        const auto& menu = pe::UI::getMenu("subscriptMenu");
+        if (!menu->isActive()) {
+            _enteringSubscript = false;
+            History::recordSubscriptChange(this, _subscriptBeforeEdit);
+        }
+        else _subscript.setString(menu->getComponent("subscriptField")->getText().getString());
+    }
+}
+
+void VisualNode::updateSize() {
+    const sf::Vector2f oldSize = _size;
     _size.x = std::max(_minWidth, _fieldText.getGlobalBounds().width + _padding * 2 + _subscript.getGlobalBounds().width);
     _size.y = std::max(_minHeight, _fieldText.getGlobalBounds().height);
 
@@ -152,26 +198,37 @@ void VisualNode::update() {
         if (hasSubscript()) _pos.x += _subscript.getGlobalBounds().width / 2.f;
     }
 
-    _children.erase(std::remove_if(_children.begin(), _children.end(), [](s_p<VisualNode> node) {return !node->isActive(); }), _children.end());
+    if (_size != oldSize) VisualTree::markLayoutChanged();
+}
 
-    if (hasParent()) {
-        const float dist = getPosition().y - _parent->getPosition().y;
-        if (dist <= pe::UI::percentToScreenHeight(Settings::nontermVerticalDistance)) {
-            if (hasChildren() || getParent()->getChildren().size() > 1 || hasSubscript() || _drawTriangle || Settings::showTermLines) {
-                move({ 0, pe::UI::percentToScreenHeight(Settings::termVerticalDistance) });
-            }
-        } else if (dist >= pe::UI::percentToScreenHeight(Settings::nontermVerticalDistance) && !Settings::showTermLines) {
-            if (!hasChildren() && getParent()->getChildren().size() == 1 && !hasSubscript() && !_drawTriangle) {
-                move({ 0, -pe::UI::percentToScreenHeight(Settings::termVerticalDistance) });
-            }
+void VisualNode::move(sf::Vector2f delta) {
+    // Layout nudges every node by rounding error each frame, which shouldn't count as a change
+    if (std::abs(delta.x) + std::abs(delta.y) > 0.01f) VisualTree::markLayoutChanged();
+    TextField::move(delta);
+}
+
+bool VisualNode::updateVerticalPosition() {
+    const float termDistance = pe::UI::percentToScreenHeight(Settings::termVerticalDistance);
+    if (!hasParent() || termDistance == 0) return false;
+
+    const float dist = getPosition().y - _parent->getPosition().y;
+    if (dist <= pe::UI::percentToScreenHeight(Settings::nontermVerticalDistance)) {
+        if (hasChildren() || getParent()->getChildren().size() > 1 || hasSubscript() || _drawTriangle || Settings::showTermLines) {
+            move({ 0, termDistance });
+            return true;
+        }
+    } else if (dist >= pe::UI::percentToScreenHeight(Settings::nontermVerticalDistance) && !Settings::showTermLines) {
+        if (!hasChildren() && getParent()->getChildren().size() == 1 && !hasSubscript() && !_drawTriangle) {
+            move({ 0, -termDistance });
+            return true;
         }
     }
+    return false;
+}
 
-    if (_enteringSubscript) {
-        const auto& menu = pe::UI::getMenu("subscriptMenu");
-        if (!menu->isActive()) _enteringSubscript = false;
-        else _subscript.setString(menu->getComponent("subscriptField")->getText().getString());
-    }
+void VisualNode::settle() {
+    updateSize();
+    for (int i = 0; i < MAX_SETTLE_STEPS && updateVerticalPosition(); i++);
 }
 
 void VisualNode::draw(sf::RenderTexture& surface) {
@@ -183,25 +240,37 @@ void VisualNode::draw(sf::RenderTexture& surface) {
     const sf::FloatRect bounds = getBounds();
     const float width = bounds.width;
     const float height = bounds.height;
+
+    if (_overlayColor.a != 0) {
+        sf::RectangleShape overlay({ width, height });
+        overlay.setPosition(bounds.left, bounds.top);
+        overlay.setFillColor(_overlayColor);
+        surface.draw(overlay);
+    }
+
+    if (_isSearchMatch) {
+        sf::RectangleShape highlight({ width, height });
+        highlight.setPosition(bounds.left, bounds.top);
+        highlight.setFillColor(_isCurrentSearchMatch ? sf::Color(255, 170, 0, 160) : sf::Color(255, 220, 0, 90));
+        surface.draw(highlight);
+    }
+
     _fieldText.setPosition(
         bounds.left + (width / 2.f) - (hasSubscript() ? _subscript.getGlobalBounds().width / 2.f : 0),
         bounds.top + (height / 2.f)
     );
 
-    surface.draw(_fieldText);
+    // The node being hovered or edited draws its own text so it stays above its buttons and cursor
+    const bool batchText = !_isArmed && !isHovered();
+    if (batchText) VisualTree::addText(_fieldText, _labelGlyphs);
+    else surface.draw(_fieldText);
 
     if (_isArmed) {
-        sf::Text cursor;
-        cursor.setString(" |");
-        cursor.setFont(PennyEngine::getFont());
-        cursor.setCharacterSize(_fieldText.getCharacterSize() + pe::UI::percentToScreenWidth(0.5f));
-        cursor.setFillColor(_fieldText.getFillColor());
-        cursor.setOrigin(cursor.getLocalBounds().width / 2.f + cursor.getLocalBounds().left, cursor.getLocalBounds().height / 2.f + cursor.getLocalBounds().top);
-        cursor.setPosition(_fieldText.getPosition().x + _fieldText.getGlobalBounds().width / 2.f, _fieldText.getPosition().y);
-        constexpr unsigned int blinkRate = 24;
-        if ((_cursorBlinkTimer / blinkRate) % 2) surface.draw(cursor);
-
-        _cursorBlinkTimer++;
+        _cursor.setCharacterSize(_fieldText.getCharacterSize() + pe::UI::percentToScreenWidth(0.5f));
+        _cursor.setFillColor(_fieldText.getFillColor());
+        _cursor.setOrigin(_cursor.getLocalBounds().width / 2.f + _cursor.getLocalBounds().left, _cursor.getLocalBounds().height / 2.f + _cursor.getLocalBounds().top);
+        _cursor.setPosition(_fieldText.getPosition().x + _fieldText.getGlobalBounds().width / 2.f, _fieldText.getPosition().y);
+        if ((int)(PennyEngine::getElapsedTime().asSeconds() / pe::CURSOR_BLINK_SECONDS) % 2) surface.draw(_cursor);
     }
 
     if (hasSubscript()) {
@@ -214,10 +283,12 @@ void VisualNode::draw(sf::RenderTexture& surface) {
             _fieldText.getPosition().x + _fieldText.getGlobalBounds().width / 2.f + subsHoriSpacing, 
             (_fieldText.getPosition().y - _fieldText.getGlobalBounds().height / 2.f) + subsVertSpacing
         );
-        surface.draw(_subscript);
+        if (batchText) VisualTree::addText(_subscript, _subscriptGlyphs);
+        else surface.draw(_subscript);
     }
 
     connectToParent(surface);
+    if (_collapsed) drawCollapsedSummary(surface);
 
     if (!_hideInterface && (!_isArmed || getBounds().contains(_mPos.x, _mPos.y)) && !isSelectingMovement()) {
         _plusButton.setPosition(_pos.x + getBounds().width - _plusButton.getSize().x, _pos.y + getBounds().height - _plusButton.getSize().y);
@@ -274,7 +345,7 @@ void VisualNode::draw(sf::RenderTexture& surface) {
     }
 
     if (_hasMovement && _endPointNode != nullptr && _endPointNode->isActive()) {
-        drawMovementLine(surface);
+        if (!_endPointNode->isHiddenByCollapse()) drawMovementLine(surface);
         if (_selectingMovement) _selectingMovement = false;
     } else if (_hasMovement && (_endPointNode == nullptr || !_endPointNode->isActive())) {
         _hasMovement = false;
@@ -286,6 +357,36 @@ void VisualNode::draw(sf::RenderTexture& surface) {
     }
 }
 
+// The count text is only needed for collapsed nodes, so one is shared between all of them
+static sf::Text& getCollapsedCountText(size_t count) {
+    static sf::Text countText;
+    if (countText.getFont() == nullptr) {
+        countText.setFont(PennyEngine::getFont());
+        countText.setCharacterSize(pe::UI::percentToScreenWidth(1.25f));
+    }
+    countText.setString("+" + std::to_string(count));
+    return countText;
+}
+
+void VisualNode::drawCollapsedSummary(sf::RenderTexture& surface) {
+    sf::Text& countText = getCollapsedCountText(_collapsedCount);
+
+    const sf::FloatRect bounds = getBounds();
+    const sf::Vector2f top = { bounds.left + bounds.width / 2.f, bounds.top + bounds.height };
+    const float height = pe::UI::percentToScreenHeight(Settings::termVerticalDistance) / 2.f;
+    const sf::Vector2f leftCorner = { bounds.left, top.y + height };
+    const sf::Vector2f rightCorner = { bounds.left + bounds.width, top.y + height };
+
+    surface.draw(Line(top, leftCorner, 4.f, Settings::lineColor));
+    surface.draw(Line(top, rightCorner, 4.f, Settings::lineColor));
+    surface.draw(Line(leftCorner, rightCorner, 4.f, Settings::lineColor));
+
+    countText.setFillColor(Settings::nonTermColor);
+    countText.setOrigin(countText.getLocalBounds().left + countText.getLocalBounds().width / 2.f, countText.getLocalBounds().top);
+    countText.setPosition(top.x, leftCorner.y + pe::UI::percentToScreenHeight(0.5f));
+    surface.draw(countText);
+}
+
 void VisualNode::drawMovementLine(sf::RenderTexture& surface) {
     const sf::Vector2f p0 = {
         getBounds().left + getBounds().width / 2.f,
@@ -304,9 +405,9 @@ void VisualNode::drawMovementLine(sf::RenderTexture& surface) {
     sf::Vector2f control = (0.5f + _curveAngle) * (p0 + p1);
     control.y += (-500.f - _curveHeight) + (p0.y + p1.y) / 2.f;
 
-    std::vector<Line> lines;
-
     const int segments = 20;
+    pe::FrameVector<Line> lines(PennyEngine::getFrameArena());
+    lines.reserve(segments);
     for (int i = 0; i < segments; ++i) {
         float t0 = i / float(segments);
         float t1 = (i + 1) / float(segments);
@@ -353,11 +454,8 @@ void VisualNode::drawMovementLine(sf::RenderTexture& surface) {
 }
 
 bool VisualNode::anotherNodeIsBlocking() const {
-    for (const auto& node : VisualTree::getNodes()) {
-        if (node->isActive() && node->getIdentifier() != getIdentifier() && node->hasMousePriority()) return true;
-    }
-
-    return false;
+    const VisualNode* priorityNode = VisualTree::getPriorityNode();
+    return priorityNode != nullptr && priorityNode != this;
 }
 
 void VisualNode::mouseButtonPressed(const int mx, const int my, const int button) {
@@ -386,14 +484,19 @@ void VisualNode::mouseButtonReleased(const int mx, const int my, const int butto
         } else if (_leftPlusButton.getGlobalBounds().contains(mx, my) && getBounds().contains(_mPos.x, _mPos.y) && button == sf::Mouse::Left) {
             addChild(true);
         } else if (hasParent() && _minusButton.getGlobalBounds().contains(mx, my) && getBounds().contains(_mPos.x, _mPos.y) && button == sf::Mouse::Left) {
+            History::recordRemoval(this);
             hide();
         } else if (Settings::enableTriangles && hasParent() && getParent()->getChildren().size() == 1 && _triangleButton.getGlobalBounds().contains(_mPos.x, _mPos.y) && button == sf::Mouse::Left) {
             _drawTriangle = !_drawTriangle;
+            History::recordTriangleToggle(this);
+        } else if (hasChildren() && getBounds().contains(_mPos.x, _mPos.y) && button == sf::Mouse::Middle) {
+            setCollapsed(!_collapsed);
         } else if (getBounds().contains(_mPos.x, _mPos.y) && button == sf::Mouse::Right) {
             const auto& menu = pe::UI::getMenu("subscriptMenu");
             menu->open();
             menu->getComponent("subscriptField")->getText().setString(_subscript.getString());
             _enteringSubscript = true;
+            _subscriptBeforeEdit = _subscript.getString();
         }
     } 
     
@@ -408,19 +511,23 @@ void VisualNode::mouseButtonReleased(const int mx, const int my, const int butto
             }
 
             if (!otherNode) {
+                _movementBeforeSelection = getMovementState();
                 _selectingMovement = true;
                 _curveHeight = 0.f;
                 _curveAngle = 0.f;
             }
         } else if (_hasMovement) {
+            const MovementState before = getMovementState();
             _hasMovement = false;
             _endPointNode = nullptr;
+            History::recordMovementChange(this, before);
         }
     } else if (isSelectingMovement() && button == sf::Mouse::Left) {
         for (const auto& node : VisualTree::getNodes()) {
-            if (node->getIdentifier() != getIdentifier() && node->getBounds().contains(mx, my)) {
+            if (node->getId() != getId() && !node->isHiddenByCollapse() && node->getBounds().contains(mx, my)) {
                 _hasMovement = true;
                 _endPointNode = node;
+                History::recordMovementChange(this, _movementBeforeSelection);
                 break;
             }
         }
@@ -437,7 +544,7 @@ void VisualNode::mouseMoved(const int mx, const int my) {
     if (isSelectingMovement()) {
         bool foundNode = false;
         for (const auto& node : VisualTree::getNodes()) {
-            if (node->getIdentifier() != getIdentifier() && node->getBounds().contains(mx, my)) {
+            if (node->getId() != getId() && !node->isHiddenByCollapse() && node->getBounds().contains(mx, my)) {
                 _endPointNode = node;
                 foundNode = true;
                 break;
@@ -481,15 +588,22 @@ float VisualNode::getMovementLineVertex() const {
     return _movementLineVertex;
 }
 
+MovementState VisualNode::getMovementState() const {
+    return { _hasMovement, _endPointNode, _curveAngle, _curveHeight };
+}
+
 void VisualNode::textEntered(const sf::Uint32 character) {
     if (_isArmed) {
-        sf::String userInput = _fieldText.getString();
+        const sf::String before = _fieldText.getString();
+        sf::String userInput = before;
+        // Control characters are left out, since shortcuts like ctrl+V and ctrl+F send them too
         if (character == '\b' && userInput.getSize()) {
             userInput.erase(userInput.getSize() - 1, 1);
-        } else if (character != '\b' && character != (char)22) {
+        } else if (character >= ' ' && character != 127) {
             userInput += character;
         }
         _fieldText.setString(userInput);
+        History::recordTextChange(this, before);
     }
 }
 
@@ -524,3 +638,72 @@ bool VisualNode::hasSubscript() const {
 std::string VisualNode::getSubscript() const {
     return _subscript.getString();
 }
+
+bool VisualNode::drawsTriangle() const {
+    return _drawTriangle;
+}
+
+void VisualNode::setCollapsed(bool collapsed) {
+    if (collapsed == _collapsed || (collapsed && !hasChildren())) return;
+    _collapsed = collapsed;
+    VisualTree::markLayoutChanged();
+
+    _collapsedCount = 0;
+    std::vector<VisualNode*> stack = { this };
+    while (collapsed && !stack.empty()) {
+        VisualNode* node = stack.back();
+        stack.pop_back();
+        for (const auto& child : node->_children) {
+            _collapsedCount++;
+            stack.push_back(child.get());
+        }
+    }
+    _collapsedSummaryWidth = collapsed ? getCollapsedCountText(_collapsedCount).getLocalBounds().width : 0.f;
+
+    for (const auto& child : _children) {
+        child->updateHiddenState();
+    }
+}
+
+bool VisualNode::isCollapsed() const {
+    return _collapsed;
+}
+
+bool VisualNode::isHiddenByCollapse() const {
+    return _hiddenByCollapse;
+}
+
+float VisualNode::getCollapsedWidth() const {
+    return std::max(getBounds().width, _collapsedSummaryWidth);
+}
+
+void VisualNode::setOverlayColor(sf::Color color) {
+    _overlayColor = color;
+}
+
+void VisualNode::updateHiddenState() {
+    std::vector<VisualNode*> stack = { this };
+    while (!stack.empty()) {
+        VisualNode* node = stack.back();
+        stack.pop_back();
+
+        node->_hiddenByCollapse = node->hasParent() && (node->_parent->_collapsed || node->_parent->_hiddenByCollapse);
+        if (node->_hiddenByCollapse) {
+            // Hidden nodes stop getting input, so drop anything they were in the middle of
+            node->releasePriority();
+            node->_isArmed = false;
+            node->_selectingMovement = false;
+        }
+
+        for (const auto& child : node->_children) {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+bool VisualNode::isConnectedToParent() {
+    if (!hasParent()) return false;
+    // Same cases connectToParent draws
+    if (_drawTriangle && getParent()->getChildren().size() == 1) return true;
+    return Settings::showTermLines || hasChildren() || getParent()->getChildren().size() > 1 || hasSubscript();
+}
@@ -6,18 +6,42 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <memory>
 #include "../../PennyEngine/ui/components/TextField.h"
 #include <SFML/Graphics/RenderTexture.hpp>
 #include "../../PennyEngine/core/Defines.h"
+#include "TextBatch.h"
 
-class VisualNode : public pe::TextField {
+// Only unique within a single run; files store their own ids as strings
+using NodeId = std::uint64_t;
+
+class VisualNode;
+
+struct MovementState {
+    bool hasMovement = false;
+    s_p<VisualNode> endPointNode = nullptr;
+    float curveAngle = 0.f;
+    float curveHeight = 0.f;
+};
+
+class VisualNode : public pe::TextField, public std::enable_shared_from_this<VisualNode> {
 public:
-    VisualNode(VisualNode* parent, float x, float y, const std::string id = "");
+    VisualNode(VisualNode* parent, float x, float y);
+    // Nodes are created often and in bulk, so they come from a pool rather than the heap
+    static s_p<VisualNode> create(VisualNode* parent, float x, float y);
+
+    NodeId getId() const;
 
     void tick();
     void visualize(sf::RenderTexture& surface);
 
+    // Moves a newly built node to where its updates would eventually leave it, so
+    // trees built in bulk don't take a frame per level to settle. Settle parents first
+    void settle();
+
     sf::Vector2f getPosition() const;
+    virtual void move(sf::Vector2f delta);
 
     std::vector<s_p<VisualNode>>& getChildren();
     VisualNode* getParent();
@@ -31,6 +55,21 @@ public:
     bool hasSubscript() const;
     std::string getSubscript() const;
 
+    bool drawsTriangle() const;
+    // Whether a line or triangle joins this node to its parent
+    bool isConnectedToParent();
+
+    // Hides everything under this node from layout, input and drawing, leaving a summary in its place
+    void setCollapsed(bool collapsed);
+    bool isCollapsed() const;
+    // Whether one of this node's ancestors is collapsed
+    bool isHiddenByCollapse() const;
+    // The box layout gives a collapsed subtree: the wider of the node and its summary
+    float getCollapsedWidth() const;
+
+    // Tints the box behind the label, e.g. to mark what changed in a comparison. Transparent turns it off
+    void setOverlayColor(sf::Color color);
+
     virtual void mouseButtonPressed(const int mx, const int my, const int button);
     virtual void mouseButtonReleased(const int mx, const int my, const int button);
     virtual void mouseWheelScrolled(sf::Event::MouseWheelScrollEvent mouseWheelScroll);
@@ -43,8 +82,13 @@ public:
     bool isSelectingMovement() const;
     bool hasMovement() const;
     float getMovementLineVertex() const;
+    MovementState getMovementState() const;
 
     friend class PersistenceImpl;
+    friend class HistoryImpl;
+    friend class VisualTreeImpl;
+    friend struct TreeSnapshot;
+    friend class LabelIndexImpl;
 protected:
     virtual void update();
     virtual void draw(sf::RenderTexture& surface); 
@@ -53,6 +97,26 @@ private:
 
     bool anotherNodeIsBlocking() const;
 
+    void updateSize();
+    // Steps the node towards its resting distance below its parent. Returns false once it's there
+    bool updateVerticalPosition();
+
+    bool _collapsed = false;
+    bool _hiddenByCollapse = false;
+    // Nodes hidden under this one, counted when it collapses
+    size_t _collapsedCount = 0;
+    // Width of the summary's count, measured when it collapses so layout doesn't measure text every frame
+    float _collapsedSummaryWidth = 0.f;
+
+    // Catches this node and its subtree up with whether their ancestors are collapsed
+    void updateHiddenState();
+    void drawCollapsedSummary(sf::RenderTexture& surface);
+
+    const NodeId _nodeId;
+
+    // Whether VisualTree is tracking this node, so restoring it from the history doesn't add it twice
+    bool _inTree = false;
+
     std::vector<s_p<VisualNode>> _children;
 
     void addChild(bool left = false);
@@ -71,10 +135,12 @@ private:
 
     sf::Text _subscript;
     bool _enteringSubscript = false;
+    sf::String _subscriptBeforeEdit;
 
     bool _selectingMovement = false;
     bool _hasMovement = false;
     s_p<VisualNode> _endPointNode = nullptr;
+    MovementState _movementBeforeSelection;
 
     float _curveAngle = 0.f;
     float _curveHeight = 0.f;
@@ -82,6 +148,18 @@ private:
     float _movementLineVertex = 0;
 
     bool _drawTriangle = false;
+
+    // Area covered by this node and everything under it, measured by VisualTree when drawing an overview
+    sf::FloatRect _subtreeBounds;
+
+    sf::Color _overlayColor = sf::Color::Transparent;
+
+    bool _isSearchMatch = false;
+    bool _isCurrentSearchMatch = false;
+
+    // Cached glyph layouts for VisualTree's text batch
+    TextBatchEntry _labelGlyphs;
+    TextBatchEntry _subscriptGlyphs;
 };
 
 #endif
\ No newline at end of file
@@ -5,16 +5,17 @@
 #include "../../PennyEngine/PennyEngine.h"
 #include "../../PennyEngine/core/Logger.h"
 #include "../core/Settings.h"
+#include "Line.h"
+#include "../core/LabelIndex.h"
 
 VisualTreeImpl::VisualTreeImpl() {
-    PennyEngine::addInputListener(this);
+    PennyEngine::addInputListener(this, VISUAL_TREE_INPUT_PRIORITY);
 }
 
 void VisualTreeImpl::update() {
     if (!_nodeBuffer.empty()) {
         for (auto& node : _nodeBuffer) {
-            _nodes.push_back(node);
-            _renderNodes.push_back(node);
+            addNode(node);
         }
     }
     _nodeBuffer.clear();
@@ -30,7 +31,14 @@ void VisualTreeImpl::update() {
         }
     }
 
-    _nodes.erase(std::remove_if(_nodes.begin(), _nodes.end(), [](s_p<VisualNode> node) { return !node->isActive(); }), _nodes.end());
+    const size_t nodeCount = _nodes.size();
+    _nodes.erase(std::remove_if(_nodes.begin(), _nodes.end(), [](const s_p<VisualNode>& node) {
+        if (node->isActive()) return false;
+        node->_inTree = false;
+        LabelIndex::removeNode(node.get());
+        return true;
+    }), _nodes.end());
+    if (_nodes.size() != nodeCount) markLayoutChanged();
     _renderNodes.erase(std::remove_if(_renderNodes.begin(), _renderNodes.end(), [](s_p<VisualNode> node) { return !node->isActive(); }), _renderNodes.end());
 
     if (_nodes.size() != 0) {
@@ -40,6 +48,9 @@ void VisualTreeImpl::update() {
 }
 
 void VisualTreeImpl::centerNodes(s_p<VisualNode> node) {
+    // Hidden nodes are laid out again when their subtree is expanded
+    if (node->isCollapsed()) return;
+
     float width = 0;
     float offset = 0;
     if (node->getChildren().size() > 0) {
@@ -60,6 +71,11 @@ SubtreeWidth VisualTreeImpl::alignNode(s_p<VisualNode> node) {
     auto& children = node->getChildren();
     float nodeWidth = node->getBounds().width;
 
+    // A collapsed subtree is a single box the width of its root or summary, whichever is wider
+    if (node->isCollapsed()) {
+        float half = node->getCollapsedWidth() * 0.5f;
+        return { half, half };
+    }
     if (children.empty()) {
         float half = nodeWidth * 0.5f;
         return { half, half };
@@ -67,7 +83,7 @@ SubtreeWidth VisualTreeImpl::alignNode(s_p<VisualNode> node) {
 
     const float horzSpace = Settings::horzSpacing;
 
-    std::vector<SubtreeWidth> cw(children.size());
+    pe::FrameVector<SubtreeWidth> cw(children.size(), PennyEngine::getFrameArena());
     for (size_t i = 0; i < children.size(); ++i) {
         cw[i] = alignNode(children[i]);
     }
@@ -103,89 +119,286 @@ SubtreeWidth VisualTreeImpl::alignNode(s_p<VisualNode> node) {
 
 
 void VisualTreeImpl::draw(sf::RenderTexture& surface) {
-    std::sort(_renderNodes.begin(), _renderNodes.end(),
-        [](s_p<VisualNode> node0, s_p<VisualNode> node1) {
-            return node1->isHovered();
+    _textBatch.clear();
+
+    if (!_nodes.empty()) {
+        const float pixelsPerUnit = (float)surface.getSize().y / surface.getView().getSize().y;
+        if (_nodes.at(0)->getBounds().height * pixelsPerUnit < LOD_LABEL_MIN_PIXELS) {
+            drawOverview(surface, pixelsPerUnit);
+            return;
+        }
+    }
+
+    // Hovered and armed nodes draw their own text and buttons, so they go last, after the batched labels,
+    // to keep them on top of their neighbours' labels
+    const auto drawsOwnText = std::stable_partition(_renderNodes.begin(), _renderNodes.end(),
+        [](const s_p<VisualNode>& node) {
+            return !node->isHovered() && !node->isArmed();
         }
     );
 
-    for (const auto& node : _renderNodes) {
-        if (node->isActive()) {
-            node->visualize(surface);
+    for (auto it = _renderNodes.begin(); it != drawsOwnText; it++) {
+        if ((*it)->isActive() && !(*it)->isHiddenByCollapse()) {
+            (*it)->visualize(surface);
+        }
+    }
+
+    _textBatch.draw(surface);
+
+    for (auto it = drawsOwnText; it != _renderNodes.end(); it++) {
+        if ((*it)->isActive() && !(*it)->isHiddenByCollapse()) {
+            (*it)->visualize(surface);
         }
     }
 }
 
-s_p<VisualNode> VisualTreeImpl::addChild(VisualNode* parent) {
+sf::Vector2f VisualTreeImpl::getChildPosition(VisualNode* parent) {
     const auto& res = PennyEngine::getRenderResolution();
-    const sf::Vector2f pos = parent == nullptr ? sf::Vector2f(50, 50) : sf::Vector2f(
+    return parent == nullptr ? sf::Vector2f(50, 50) : sf::Vector2f(
         parent->getPosition().x / res.width * 100.f + (parent->getBounds().width / 2.f / res.width * 100.f), 
         parent->getPosition().y / res.height * 100.f + Settings::nontermVerticalDistance
     );
+}
+
+void VisualTreeImpl::drawOverview(sf::RenderTexture& surface) {
+    if (_nodes.empty()) return;
+    drawOverview(surface, (float)surface.getSize().y / surface.getView().getSize().y);
+}
+
+void VisualTreeImpl::drawOverview(sf::RenderTexture& surface, float pixelsPerUnit) {
+    const auto& root = _nodes.at(0);
+    measureSubtree(root.get());
+
+    const sf::View& view = surface.getView();
+    const sf::FloatRect visibleArea(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+    _overviewVertices.clear();
+    addOverviewNode(root.get(), visibleArea, pixelsPerUnit);
+    surface.draw(_overviewVertices);
+}
+
+void VisualTreeImpl::measureSubtree(VisualNode* node) {
+    sf::FloatRect& extent = node->_subtreeBounds;
+    extent = node->getBounds();
+    if (node->isCollapsed()) return;
+
+    for (const auto& child : node->getChildren()) {
+        if (!child->isActive()) continue;
+        measureSubtree(child.get());
+
+        const sf::FloatRect& childExtent = child->_subtreeBounds;
+        const float right = std::max(extent.left + extent.width, childExtent.left + childExtent.width);
+        const float bottom = std::max(extent.top + extent.height, childExtent.top + childExtent.height);
+        extent.left = std::min(extent.left, childExtent.left);
+        extent.top = std::min(extent.top, childExtent.top);
+        extent.width = right - extent.left;
+        extent.height = bottom - extent.top;
+    }
+}
 
-    const auto& newNode = new_s_p(VisualNode, (parent, pos.x, pos.y));
+static void addRectangle(sf::VertexArray& vertices, const sf::FloatRect& rect, sf::Color color) {
+    vertices.append({ { rect.left, rect.top }, color });
+    vertices.append({ { rect.left + rect.width, rect.top }, color });
+    vertices.append({ { rect.left + rect.width, rect.top + rect.height }, color });
+    vertices.append({ { rect.left, rect.top + rect.height }, color });
+}
+
+void VisualTreeImpl::addOverviewNode(VisualNode* node, const sf::FloatRect& visibleArea, float pixelsPerUnit) {
+    const sf::FloatRect& extent = node->_subtreeBounds;
+    if (!extent.intersects(visibleArea)) return;
+
+    // Lines stay at least a pixel wide however far out the camera is
+    const float thickness = std::max(4.f, 1.f / pixelsPerUnit);
+
+    if (node->hasChildren() && !node->isCollapsed() && std::max(extent.width, extent.height) * pixelsPerUnit < LOD_SUBTREE_MIN_PIXELS) {
+        const sf::Vector2f topLeft(extent.left, extent.top);
+        const sf::Vector2f topRight(extent.left + extent.width, extent.top);
+        const sf::Vector2f bottomLeft(extent.left, extent.top + extent.height);
+        const sf::Vector2f bottomRight(extent.left + extent.width, extent.top + extent.height);
+        Line(topLeft, topRight, thickness, Settings::lineColor).appendTo(_overviewVertices);
+        Line(topRight, bottomRight, thickness, Settings::lineColor).appendTo(_overviewVertices);
+        Line(bottomRight, bottomLeft, thickness, Settings::lineColor).appendTo(_overviewVertices);
+        Line(bottomLeft, topLeft, thickness, Settings::lineColor).appendTo(_overviewVertices);
+        return;
+    }
+
+    // Stands in for the label, roughly where its text would be
+    const sf::FloatRect bounds = node->getBounds();
+    const sf::FloatRect label(bounds.left + bounds.width * 0.2f, bounds.top + bounds.height * 0.3f, bounds.width * 0.6f, bounds.height * 0.4f);
+    addRectangle(_overviewVertices, label, !node->hasChildren() && !node->hasSubscript() ? Settings::termColor : Settings::nonTermColor);
+
+    if (node->isCollapsed()) return;
+
+    const sf::Vector2f bottom(bounds.left + bounds.width / 2.f, bounds.top + bounds.height);
+    for (const auto& child : node->getChildren()) {
+        if (!child->isActive()) continue;
+
+        if (child->isConnectedToParent()) {
+            const sf::FloatRect childBounds = child->getBounds();
+            Line(bottom, { childBounds.left + childBounds.width / 2.f, childBounds.top }, thickness, Settings::lineColor).appendTo(_overviewVertices);
+        }
+        addOverviewNode(child.get(), visibleArea, pixelsPerUnit);
+    }
+}
+
+s_p<VisualNode> VisualTreeImpl::addChild(VisualNode* parent) {
+    const sf::Vector2f pos = getChildPosition(parent);
+    const auto& newNode = VisualNode::create(parent, pos.x, pos.y);
 
     _nodeBuffer.push_back(newNode);
+    newNode->_inTree = true;
     return newNode;
 }
 
+void VisualTreeImpl::addNode(const s_p<VisualNode>& node) {
+    _nodes.push_back(node);
+    _renderNodes.push_back(node);
+    node->_inTree = true;
+    markLayoutChanged();
+    LabelIndex::updateNode(node.get());
+}
+
+s_p<VisualNode> VisualTreeImpl::build(const TreeSnapshot& tree) {
+    std::vector<s_p<VisualNode>> nodes = tree.createNodes(nullptr, false);
+
+    // Preorder, so every parent is in place before its children
+    for (const auto& node : nodes) {
+        node->settle();
+        node->_inTree = true;
+    }
+
+    if (!nodes.empty()) {
+        alignNode(nodes.at(0));
+        if (Settings::center) centerNodes(nodes.at(0));
+    }
+
+    for (const auto& node : _nodes) {
+        node->_inTree = false;
+    }
+    _nodeBuffer.clear();
+    _renderNodes = nodes;
+    _nodes = std::move(nodes);
+    markLayoutChanged();
+    LabelIndex::rebuild(_nodes);
+
+    return _nodes.empty() ? nullptr : _nodes.at(0);
+}
+
+void VisualTreeImpl::restoreNode(const s_p<VisualNode>& node) {
+    // Nodes removed this frame haven't been dropped from the tree yet
+    if (node->_inTree) return;
+
+    _nodeBuffer.push_back(node);
+    node->_inTree = true;
+}
+
 static sf::Vector2f mapMouseCoordinates(const int mx, const int my) {
     const sf::Vector2i mouseCoords(mx, my);
 
     return PennyEngine::getWindow().mapPixelToCoords(mouseCoords, PennyEngine::getCamera());
 }
 
-void VisualTreeImpl::mouseButtonPressed(const int mx, const int my, const int button) {
-    const auto mousePos = mapMouseCoordinates(mx, my);
+template<typename Handler>
+void VisualTreeImpl::dispatch(Handler handler) {
+    _priorityNode = nullptr;
+    for (const auto& node : _nodes) {
+        if (node->isActive() && !node->isHiddenByCollapse() && node->hasMousePriority()) {
+            _priorityNode = node.get();
+            break;
+        }
+    }
 
+    // A node can only change its own priority while handling an event, so only it needs checking again
     for (const auto& node : _nodes) {
-        if (node->isActive()) {
-            node->mouseButtonPressed(mousePos.x, mousePos.y, button);
+        if (node->isActive() && !node->isHiddenByCollapse()) {
+            handler(node.get());
+
+            if (_priorityNode == node.get() && !node->hasMousePriority()) _priorityNode = nullptr;
+            else if (_priorityNode == nullptr && node->isActive() && node->hasMousePriority()) _priorityNode = node.get();
         }
     }
+
+    _priorityNode = nullptr;
+}
+
+void VisualTreeImpl::mouseButtonPressed(const int mx, const int my, const int button) {
+    const auto mousePos = mapMouseCoordinates(mx, my);
+
+    bool hitNode = false;
+    dispatch([&](VisualNode* node) {
+        node->mouseButtonPressed(mousePos.x, mousePos.y, button);
+        hitNode = hitNode || node->getBounds().contains(mousePos);
+    });
+
+    // Keeps the camera from panning when dragging from a node
+    if (hitNode) consumeEvent();
 }
 
 void VisualTreeImpl::mouseButtonReleased(const int mx, const int my, const int button) {
     const auto mousePos = mapMouseCoordinates(mx, my);
 
-    for (const auto& node : _nodes) {
-        if (node->isActive()) {
-            node->mouseButtonReleased(mousePos.x, mousePos.y, button);
-        }
-    }
+    dispatch([&](VisualNode* node) {
+        node->mouseButtonReleased(mousePos.x, mousePos.y, button);
+    });
 }
 
 void VisualTreeImpl::mouseMoved(const int mx, const int my) {
     const auto mousePos = mapMouseCoordinates(mx, my);
 
-    for (const auto& node : _nodes) {
-        if (node->isActive()) {
-            node->mouseMoved(mousePos.x, mousePos.y);
-        }
-    }
+    dispatch([&](VisualNode* node) {
+        node->mouseMoved(mousePos.x, mousePos.y);
+    });
 }
 
 void VisualTreeImpl::mouseWheelScrolled(sf::Event::MouseWheelScrollEvent mouseWheelScroll) {
-    for (const auto& node : _nodes) {
-        if (node->isActive()) {
-            node->mouseWheelScrolled(mouseWheelScroll);
-        }
+    bool adjustingMovement = false;
+    dispatch([&](VisualNode* node) {
+        node->mouseWheelScrolled(mouseWheelScroll);
+        adjustingMovement = adjustingMovement || node->isSelectingMovement();
+    });
+
+    // Ctrl and alt scroll the curve of a movement line being drawn rather than zooming
+    if (adjustingMovement && (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::LAlt))) {
+        consumeEvent();
     }
 }
 
 void VisualTreeImpl::textEntered(sf::Uint32 character) {
-    for (const auto& node : _nodes) {
-        if (node->isActive()) {
-            node->textEntered(character);
-        }
-    }
+    dispatch([&](VisualNode* node) {
+        node->textEntered(character);
+    });
 }
 
-std::vector<s_p<VisualNode>> VisualTreeImpl::getNodes() {
+const std::vector<s_p<VisualNode>>& VisualTreeImpl::getNodes() const {
     return _nodes;
 }
 
+void VisualTreeImpl::addText(const sf::Text& text, TextBatchEntry& entry) {
+    _textBatch.add(text, entry);
+}
+
+const VisualNode* VisualTreeImpl::getPriorityNode() const {
+    return _priorityNode;
+}
+
+void VisualTreeImpl::markLayoutChanged() {
+    _layoutRevision++;
+}
+
+unsigned int VisualTreeImpl::getLayoutRevision() const {
+    return _layoutRevision;
+}
+
+sf::FloatRect VisualTreeImpl::getTreeBounds() {
+    if (_nodes.empty()) return {};
+
+    measureSubtree(_nodes.at(0).get());
+    return _nodes.at(0)->_subtreeBounds;
+}
+
 void VisualTreeImpl::reset() {
     _nodes.clear();
     _renderNodes.clear();
+    markLayoutChanged();
+    LabelIndex::clear();
 }
\ No newline at end of file
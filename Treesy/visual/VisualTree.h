@@ -5,11 +5,22 @@
 #define _VISUAL_TREE_H
 
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include "VisualNode.h"
+#include "TextBatch.h"
+#include "../core/TreeSnapshot.h"
 #include "../../PennyEngine/core/Defines.h"
 #include "../../PennyEngine/input/KeyListener.h"
 #include "../../PennyEngine/input/MouseListener.h"
 
+// Below this many pixels tall on screen, nodes are drawn as plain boxes in one batch instead of as text
+constexpr float LOD_LABEL_MIN_PIXELS = 8.f;
+// Subtrees smaller than this on screen are drawn as a single outline
+constexpr float LOD_SUBTREE_MIN_PIXELS = 12.f;
+
+// Nodes are under the menus but above the camera controls in ProgramManager
+constexpr int VISUAL_TREE_INPUT_PRIORITY = 10;
+
 struct SubtreeWidth {
     float left;
     float right;
@@ -23,12 +34,36 @@ public:
     void draw(sf::RenderTexture& surface);
 
     s_p<VisualNode> addChild(VisualNode* parent);
+    void addNode(const s_p<VisualNode>& node);
+
+    // Replaces the whole tree with one built from tree, already settled and laid out.
+    // Skips the buffer addChild uses, so it can't be called while the nodes are being iterated
+    s_p<VisualNode> build(const TreeSnapshot& tree);
+    void restoreNode(const s_p<VisualNode>& node);
+
+    const std::vector<s_p<VisualNode>>& getNodes() const;
+
+    // Queues text to be drawn with every other node's labels at the end of draw
+    void addText(const sf::Text& text, TextBatchEntry& entry);
+
+    // The node that the others ignore mouse input behind while an event is being handed out
+    const VisualNode* getPriorityNode() const;
+
+    // Bumped whenever nodes are added, removed, moved, resized or collapsed, so cached drawings of the tree know to redraw
+    void markLayoutChanged();
+    unsigned int getLayoutRevision() const;
 
-    std::vector<s_p<VisualNode>> getNodes();
+    // Area covered by every visible node
+    sf::FloatRect getTreeBounds();
+    // Draws the whole tree as it's drawn when zoomed far out, whatever the surface's zoom
+    void drawOverview(sf::RenderTexture& surface);
 
     void reset();
 
     friend class PersistenceImpl;
+    friend class BenchmarkManager;
+    friend class HistoryImpl;
+    friend struct TreeSnapshot;
 protected:
     virtual void mouseButtonPressed(const int mx, const int my, const int button);
     virtual void mouseButtonReleased(const int mx, const int my, const int button);
@@ -43,8 +78,27 @@ private:
 
     std::vector<s_p<VisualNode>> _nodeBuffer;
 
+    static sf::Vector2f getChildPosition(VisualNode* parent);
+
     SubtreeWidth alignNode(s_p<VisualNode> node);
     void centerNodes(s_p<VisualNode> node);
+
+    // Reused between frames so zoomed out views don't reallocate their geometry
+    sf::VertexArray _overviewVertices = sf::VertexArray(sf::Quads);
+
+    TextBatch _textBatch;
+
+    VisualNode* _priorityNode = nullptr;
+
+    unsigned int _layoutRevision = 0;
+
+    // Hands an event to every visible node, keeping track of which one has mouse priority as it goes
+    template<typename Handler>
+    void dispatch(Handler handler);
+
+    void drawOverview(sf::RenderTexture& surface, float pixelsPerUnit);
+    void measureSubtree(VisualNode* node);
+    void addOverviewNode(VisualNode* node, const sf::FloatRect& visibleArea, float pixelsPerUnit);
 };
 
 class VisualTree {
@@ -61,15 +115,45 @@ public:
         return _instance.addChild(parent);
     }
 
-    static std::vector<s_p<VisualNode>> getNodes() {
+    static s_p<VisualNode> build(const TreeSnapshot& tree) {
+        return _instance.build(tree);
+    }
+
+    static const std::vector<s_p<VisualNode>>& getNodes() {
         return _instance.getNodes();
     }
 
+    static void addText(const sf::Text& text, TextBatchEntry& entry) {
+        _instance.addText(text, entry);
+    }
+
+    static const VisualNode* getPriorityNode() {
+        return _instance.getPriorityNode();
+    }
+
+    static void markLayoutChanged() {
+        _instance.markLayoutChanged();
+    }
+
+    static unsigned int getLayoutRevision() {
+        return _instance.getLayoutRevision();
+    }
+
+    static sf::FloatRect getTreeBounds() {
+        return _instance.getTreeBounds();
+    }
+
+    static void drawOverview(sf::RenderTexture& surface) {
+        _instance.drawOverview(surface);
+    }
+
     static void reset() {
         _instance.reset();
     }
 
     friend class PersistenceImpl;
+    friend class BenchmarkManager;
+    friend class HistoryImpl;
 private:
     static inline VisualTreeImpl _instance;
 };